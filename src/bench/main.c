@@ -0,0 +1,118 @@
+/*
+* Micro benchmarks for the kiss-ds data structures.
+* Build in release mode, results are printed as nanoseconds per operation.
+* Each result is the fastest of BENCH_REPEATS runs, with the runs of the variants
+* being compared interleaved, so a noisy machine affects them alike.
+*/
+#include <stdio.h>
+#include <time.h>
+#include "../kiss-ds/KISS_RING.h"
+
+#define BENCH_RING_SIZE 1024
+#define BENCH_RING_BATCH 512
+#define BENCH_ITERATIONS 20000
+#define BENCH_REPEATS 9
+
+KISS_RING_DEFINE(BENCH_RING, KISS_UINT, BENCH_RING_SIZE)
+
+static double bench_now_ns(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/* Fill half the ring then drain it again, BENCH_ITERATIONS times */
+static double bench_ring_put_get(KISS_RING* pRB) {
+    KISS_UINT sum = 0;
+    const double start = bench_now_ns();
+    for (KISS_UINT i = 0; i < BENCH_ITERATIONS; ++i) {
+        for (KISS_UINT j = 0; j < BENCH_RING_BATCH; ++j) {
+            KISS_RING_Put(pRB, &j);
+        }
+        for (KISS_UINT j = 0; j < BENCH_RING_BATCH; ++j) {
+            KISS_UINT v = 0;
+            KISS_RING_Get(pRB, &v);
+            sum += v;
+        }
+    }
+    const double elapsed = bench_now_ns() - start;
+    if (sum == 0) {
+        printf("unexpected checksum\n");
+    }
+    return elapsed / ((double)BENCH_ITERATIONS * BENCH_RING_BATCH * 2);
+}
+
+/* Same traffic as bench_ring_put_get() but moved with a single bulk call per batch */
+static double bench_ring_putn_getn(KISS_RING* pRB) {
+    static KISS_UINT batch[BENCH_RING_BATCH];
+    KISS_UINT sum = 0;
+    const double start = bench_now_ns();
+    for (KISS_UINT i = 0; i < BENCH_ITERATIONS; ++i) {
+        batch[0] = i;
+        KISS_RING_PutN(pRB, batch, BENCH_RING_BATCH);
+        KISS_RING_GetN(pRB, batch, BENCH_RING_BATCH);
+        sum += batch[0];
+    }
+    const double elapsed = bench_now_ns() - start;
+    if (sum == 0) {
+        printf("unexpected checksum\n");
+    }
+    return elapsed / ((double)BENCH_ITERATIONS * BENCH_RING_BATCH * 2);
+}
+
+/* Same traffic as bench_ring_put_get() on a ring generated with KISS_RING_DEFINE() */
+static double bench_typed_ring_put_get(BENCH_RING* pRB) {
+    KISS_UINT sum = 0;
+    const double start = bench_now_ns();
+    for (KISS_UINT i = 0; i < BENCH_ITERATIONS; ++i) {
+        for (KISS_UINT j = 0; j < BENCH_RING_BATCH; ++j) {
+            BENCH_RING_Put(pRB, &j);
+        }
+        for (KISS_UINT j = 0; j < BENCH_RING_BATCH; ++j) {
+            KISS_UINT v = 0;
+            BENCH_RING_Get(pRB, &v);
+            sum += v;
+        }
+    }
+    const double elapsed = bench_now_ns() - start;
+    if (sum == 0) {
+        printf("unexpected checksum\n");
+    }
+    return elapsed / ((double)BENCH_ITERATIONS * BENCH_RING_BATCH * 2);
+}
+
+static void bench_ring(void) {
+    static BENCH_RING typed_ring;
+    static KISS_UINT buffer[BENCH_RING_SIZE];
+    KISS_RING ring;
+
+    double modulo = 1e9;
+    double pow2 = 1e9;
+    double batch = 1e9;
+    double typed = 1e9;
+
+    for (int r = 0; r < BENCH_REPEATS; ++r) {
+        KISS_RING_CreateEx(&ring, sizeof(KISS_UINT), BENCH_RING_SIZE, buffer, KISS_RING_FLAG_MODULO);
+        modulo = KISS_MIN(modulo, bench_ring_put_get(&ring));
+        KISS_RING_Delete(&ring);
+
+        KISS_RING_CreateEx(&ring, sizeof(KISS_UINT), BENCH_RING_SIZE, buffer, KISS_RING_FLAG_POW2);
+        pow2 = KISS_MIN(pow2, bench_ring_put_get(&ring));
+        batch = KISS_MIN(batch, bench_ring_putn_getn(&ring));
+        KISS_RING_Delete(&ring);
+
+        BENCH_RING_Create(&typed_ring);
+        typed = KISS_MIN(typed, bench_typed_ring_put_get(&typed_ring));
+    }
+    printf("KISS_RING Put/Get (modulo):      %6.2f ns/op\n", modulo);
+    printf("KISS_RING Put/Get (power of 2):  %6.2f ns/op\n", pow2);
+    printf("KISS_RING PutN/GetN (batch %d): %6.2f ns/op\n", BENCH_RING_BATCH, batch);
+    printf("KISS_RING_DEFINE Put/Get:        %6.2f ns/op\n", typed);
+}
+
+int main(int argc, char** argv) {
+    (void)argc;
+    (void)argv;
+    bench_ring();
+    return 0;
+}
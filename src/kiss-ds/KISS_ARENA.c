@@ -29,6 +29,14 @@
 *=================================================================================*/
 #include "KISS_ARENA.h"
 
+/* Internal function to allocate memory from the current block. Returns NULL if it doesn't fit */
+static void* __alloc_top(KISS_ARENA* pA, KISS_UINT Size, KISS_UINT Alignment);
+/* Internal function to make a new block of at least MinSize bytes the current block. Returns 0 on success */
+static int __grow(KISS_ARENA* pA, KISS_UINT MinSize);
+/* Internal functions used for the blocks of a growable arena if no callbacks are provided */
+static void* __heap_alloc(void* pUser, KISS_UINT Size);
+static void __heap_free(void* pUser, void* pBlock);
+
 /* ===============================================================================
 * Name: KISS_ARENA_Create()
 * Description: Create an arena allocator using the provided buffer
@@ -41,9 +49,39 @@
 void KISS_ARENA_Create(KISS_ARENA* pA, void* pBuffer, KISS_UINT Size) {
     KISS_ASSERT(pA != NULL, "Arena must be a valid pointer");
     pA->ArenaSize = Size;
-    pA->pArena = (uint8_t*)pBuffer + Size - 1;
+    /* Allocations grow down from the end of the buffer */
+    pA->pArena = (uint8_t*)pBuffer + Size;
     pA->pArenaTop = pA->pArena;
+    pA->NumPrevBytes = 0;
+    pA->pBlocks = NULL;
+    pA->pfnAlloc = NULL;
+    pA->pfnFree = NULL;
+    pA->pUser = NULL;
+    pA->MarkDepth = 0;
+}
 
+/* ===============================================================================
+* Name: KISS_ARENA_CreateGrowable()
+* Description: Create an arena allocator that obtains additional blocks when the
+*              current block is exhausted.
+* Parameters:   [O] pA - Pointer to arena object to initialise
+*               [I] pBuffer - Pointer to memory to use for the first block. May be NULL.
+*               [I] Size - Total size (in bytes) of the memory buffer to use.
+*               [I] pfnAlloc - Function to obtain a block, or NULL to use KISS_HEAP_ALLOC.
+*               [I] pfnFree - Function to release a block, or NULL to use KISS_HEAP_FREE.
+*               [I] pUser - Passed to pfnAlloc and pfnFree.
+* Return: None
+* Caution/Notes: Each new block is at least twice the size of the previous one (and
+*                at least KISS_ARENA_MIN_BLOCK_SIZE), so allocations stay on the
+*                bump pointer fast path after a few blocks. KISS_ARENA_Delete()
+*                releases the blocks, pBuffer remains owned by the caller.
+================================================================================== */
+void KISS_ARENA_CreateGrowable(KISS_ARENA* pA, void* pBuffer, KISS_UINT Size, KISS_ARENA_ALLOC_FN pfnAlloc, KISS_ARENA_FREE_FN pfnFree, void* pUser) {
+    KISS_ASSERT((pfnAlloc == NULL) == (pfnFree == NULL), "Both or neither of the block functions must be provided");
+    KISS_ARENA_Create(pA, pBuffer, (pBuffer != NULL) ? Size : 0);
+    pA->pfnAlloc = (pfnAlloc != NULL) ? pfnAlloc : __heap_alloc;
+    pA->pfnFree = (pfnFree != NULL) ? pfnFree : __heap_free;
+    pA->pUser = pUser;
 }
 
 /* ===============================================================================
@@ -55,6 +93,16 @@ void KISS_ARENA_Create(KISS_ARENA* pA, void* pBuffer, KISS_UINT Size) {
 ================================================================================== */
 void KISS_ARENA_Delete(KISS_ARENA* pA) {
     KISS_ASSERT(pA != NULL, "Arena must be a valid pointer");
+    while (pA->pBlocks != NULL) {
+        KISS_ARENA_BLOCK* pPrev = pA->pBlocks->pPrev;
+        pA->pfnFree(pA->pUser, pA->pBlocks);
+        pA->pBlocks = pPrev;
+    }
+    pA->NumPrevBytes = 0;
+    pA->pfnAlloc = NULL;
+    pA->pfnFree = NULL;
+    pA->pUser = NULL;
+    pA->MarkDepth = 0;
     pA->ArenaSize = 0;
     pA->pArenaTop = NULL;
     pA->pArena = NULL;
@@ -65,10 +113,20 @@ void KISS_ARENA_Delete(KISS_ARENA* pA) {
 * Description: Reset the arena to the default empty state.
 * Parameters: [O] pA - Pointer to arena object to modify.
 * Return: None
-* Caution/Notes: None
+* Caution/Notes: A growable arena releases all blocks except the current one, which
+*                is the largest, and keeps allocating from it.
 ================================================================================== */
 void KISS_ARENA_Clear(KISS_ARENA* pA) {
     KISS_ASSERT(pA != NULL, "Arena must be a valid pointer");
+    if (pA->pBlocks != NULL) {
+        while (pA->pBlocks->pPrev != NULL) {
+            KISS_ARENA_BLOCK* pPrev = pA->pBlocks->pPrev;
+            pA->pBlocks->pPrev = pPrev->pPrev;
+            pA->pfnFree(pA->pUser, pPrev);
+        }
+    }
+    pA->NumPrevBytes = 0;
+    pA->MarkDepth = 0;
     pA->pArenaTop = pA->pArena;
 }
 
@@ -81,7 +139,7 @@ void KISS_ARENA_Clear(KISS_ARENA* pA) {
 ================================================================================== */
 int KISS_ARENA_BytesAllocated(const KISS_ARENA* pA) {
     KISS_ASSERT(pA != NULL, "Arena must be a valid pointer");
-    return (KISS_UINT)((uint8_t*)pA->pArena - (uint8_t*)pA->pArenaTop);
+    return (KISS_UINT)(pA->NumPrevBytes + ((uint8_t*)pA->pArena - (uint8_t*)pA->pArenaTop));
 }
 
 /* ===============================================================================
@@ -90,17 +148,10 @@ int KISS_ARENA_BytesAllocated(const KISS_ARENA* pA) {
 * Parameters:   [I/O] pA - Pointer to array object to modify
 *               [I] Size - Amount of memory to allocate.
 * Return: void * - Returns newly allocate memory or NULL if not successful.
-* Caution/Notes: None
+* Caution/Notes: A growable arena only fails if no new block can be obtained.
 ================================================================================== */
 void* KISS_ARENA_Alloc(KISS_ARENA* pA, KISS_UINT Size) {
-    KISS_ASSERT(pA != NULL, "Arena must be a valid pointer");
-    void* pResult = (uint8_t*)pA->pArenaTop - Size;
-    if ((uint8_t*)pResult >= ((uint8_t*)pA->pArena - pA->ArenaSize)) {
-        pA->pArenaTop = pResult;
-        return pResult;
-    }
-
-    return NULL;
+    return KISS_ARENA_AllocEx(pA, Size, 1);
 }
 /* ===============================================================================
 * Name: KISS_ARENA_AllocEx()
@@ -109,14 +160,112 @@ void* KISS_ARENA_Alloc(KISS_ARENA* pA, KISS_UINT Size) {
 *               [I] Size - Amount of memory to allocate.
 *               [I] Alignment - Alignment of memory to allocate. Must be a power of 2.
 * Return: void * - Returns newly allocated memory or NULL if not successful.
-* Caution/Notes: None
+* Caution/Notes: A growable arena only fails if no new block can be obtained.
 ================================================================================== */
 void* KISS_ARENA_AllocEx(KISS_ARENA* pA, KISS_UINT Size, KISS_UINT Alignment) {
     KISS_ASSERT(pA != NULL, "Arena must be a valid pointer");
-    void* pResult = KISS_ALIGN_DOWN_PTR((uint8_t*)pA->pArenaTop - Size,Alignment);
-    if ((uint8_t*)pResult >= ((uint8_t*)pA->pArena - pA->ArenaSize)) {
-        pA->pArenaTop = pResult;
-        return pResult;
+    KISS_ASSERT(KISS_IS_POW2(Alignment), "The alignment must be a power of 2");
+    void* pResult = __alloc_top(pA, Size, Alignment);
+    if (pResult == NULL && pA->pfnAlloc != NULL && Size <= 0xFFFFFFFFu - Alignment) {
+        /* Spill into a new block, leaving the rest of the current block unused */
+        if (__grow(pA, Size + Alignment) == 0) {
+            pResult = __alloc_top(pA, Size, Alignment);
+        }
+    }
+    return pResult;
+}
+
+/* ===============================================================================
+* Name: KISS_ARENA_Mark()
+* Description: Capture the current top of the arena so a scope can release its
+*              allocations with KISS_ARENA_Rewind().
+* Parameters:   [I/O] pA - Pointer to arena object
+*               [O] pMark - Pointer to receive the state of the arena
+* Return: None
+* Caution/Notes: Marks nest. KISS_ARENA_Clear() invalidates all marks.
+================================================================================== */
+void KISS_ARENA_Mark(KISS_ARENA* pA, KISS_ARENA_MARK* pMark) {
+    KISS_ASSERT(pA != NULL, "Arena must be a valid pointer");
+    KISS_ASSERT(pMark != NULL, "Mark must be a valid pointer");
+    pMark->pArena = pA->pArena;
+    pMark->pArenaTop = pA->pArenaTop;
+    pMark->ArenaSize = pA->ArenaSize;
+    pMark->NumPrevBytes = pA->NumPrevBytes;
+    pMark->pBlock = pA->pBlocks;
+    pMark->Depth = ++pA->MarkDepth;
+}
+
+/* ===============================================================================
+* Name: KISS_ARENA_Rewind()
+* Description: Release all memory allocated since the mark was taken.
+* Parameters:   [I/O] pA - Pointer to arena object to modify
+*               [I] pMark - Mark captured by KISS_ARENA_Mark()
+* Return: None
+* Caution/Notes: Rewinding an outer mark also releases any inner marks, which must
+*                not be used afterwards; debug builds assert on such a stale mark.
+*                A growable arena releases the blocks obtained after the mark.
+================================================================================== */
+void KISS_ARENA_Rewind(KISS_ARENA* pA, const KISS_ARENA_MARK* pMark) {
+    KISS_ASSERT(pA != NULL, "Arena must be a valid pointer");
+    KISS_ASSERT(pMark != NULL, "Mark must be a valid pointer");
+    KISS_ASSERT(pMark->Depth > 0 && pMark->Depth <= pA->MarkDepth, "Mark was already released by an older mark");
+    KISS_ASSERT(pMark->pBlock != pA->pBlocks || (uintptr_t)pMark->pArenaTop >= (uintptr_t)pA->pArenaTop,
+                "Mark is below the top of the arena");
+    while (pA->pBlocks != pMark->pBlock && pA->pBlocks != NULL) {
+        KISS_ARENA_BLOCK* pPrev = pA->pBlocks->pPrev;
+        pA->pfnFree(pA->pUser, pA->pBlocks);
+        pA->pBlocks = pPrev;
+    }
+    pA->pArena = pMark->pArena;
+    pA->pArenaTop = pMark->pArenaTop;
+    pA->ArenaSize = pMark->ArenaSize;
+    pA->NumPrevBytes = pMark->NumPrevBytes;
+    pA->MarkDepth = pMark->Depth - 1;
+}
+
+static void* __alloc_top(KISS_ARENA* pA, KISS_UINT Size, KISS_UINT Alignment) {
+    const uintptr_t Top = (uintptr_t)pA->pArenaTop;
+    const uintptr_t Bottom = (uintptr_t)pA->pArena - pA->ArenaSize;
+    if (Size <= Top - Bottom) {
+        const uintptr_t Result = KISS_ALIGN_DOWN(Top - Size, (uintptr_t)Alignment);
+        if (Result >= Bottom) {
+            pA->pArenaTop = (void*)Result;
+            return pA->pArenaTop;
+        }
     }
     return NULL;
 }
+
+static int __grow(KISS_ARENA* pA, KISS_UINT MinSize) {
+    const KISS_UINT HdrSize = KISS_ALIGN_UP((KISS_UINT)sizeof(KISS_ARENA_BLOCK), 16u);
+    /* Geometric growth keeps the number of blocks logarithmic in the peak usage */
+    uint64_t Size = KISS_MAX((uint64_t)pA->ArenaSize * 2, (uint64_t)KISS_ARENA_MIN_BLOCK_SIZE);
+    Size = KISS_MAX(Size, (uint64_t)MinSize + HdrSize);
+    Size = KISS_ALIGN_UP(Size, (uint64_t)16);
+    if (Size > 0xFFFFFFFFu) {
+        return 1;
+    }
+    KISS_ARENA_BLOCK* pBlock = (KISS_ARENA_BLOCK*)pA->pfnAlloc(pA->pUser, (KISS_UINT)Size);
+    if (pBlock == NULL) {
+        return 1;
+    }
+    pBlock->Size = (KISS_UINT)Size;
+    pBlock->pPrev = pA->pBlocks;
+    pA->pBlocks = pBlock;
+    pA->NumPrevBytes += (KISS_UINT)((uint8_t*)pA->pArena - (uint8_t*)pA->pArenaTop);
+    /* The new block becomes the current block */
+    pA->ArenaSize = pBlock->Size - HdrSize;
+    pA->pArena = (uint8_t*)pBlock + pBlock->Size;
+    pA->pArenaTop = pA->pArena;
+    return 0;
+}
+
+static void* __heap_alloc(void* pUser, KISS_UINT Size) {
+    (void)pUser;
+    return KISS_HEAP_ALLOC(Size);
+}
+
+static void __heap_free(void* pUser, void* pBlock) {
+    (void)pUser;
+    KISS_HEAP_FREE(pBlock);
+}
@@ -35,18 +35,52 @@
 extern "C" {
 #endif
 
-/* KISS_ARENA implements a linear/arena allocator */
+/* Callbacks used by a growable arena to obtain and release additional blocks */
+typedef void* (*KISS_ARENA_ALLOC_FN)(void* pUser, KISS_UINT Size);
+typedef void (*KISS_ARENA_FREE_FN)(void* pUser, void* pBlock);
+
+/* Minimum size of the blocks obtained by a growable arena */
+#ifndef KISS_ARENA_MIN_BLOCK_SIZE
+#define KISS_ARENA_MIN_BLOCK_SIZE 4096
+#endif
+
+/* Header at the start of each block obtained by a growable arena */
+typedef struct KISS_ARENA_BLOCK {
+    struct KISS_ARENA_BLOCK* pPrev;
+    KISS_UINT Size;
+} KISS_ARENA_BLOCK;
+
+/* KISS_ARENA implements a linear/arena allocator. Allocations grow down from the end of the current block */
 typedef struct KISS_ARENA {
     void* pArena;
     void* pArenaTop;
     KISS_UINT ArenaSize;
+    KISS_UINT NumPrevBytes; /* Bytes allocated in blocks before the current one */
+    KISS_ARENA_BLOCK* pBlocks; /* Blocks obtained by a growable arena, current block first */
+    KISS_ARENA_ALLOC_FN pfnAlloc; /* NULL unless the arena is growable */
+    KISS_ARENA_FREE_FN pfnFree;
+    void* pUser;
+    KISS_UINT MarkDepth; /* Number of marks not yet rewound */
 } KISS_ARENA;
 
+/* State of an arena captured by KISS_ARENA_Mark() */
+typedef struct KISS_ARENA_MARK {
+    void* pArena;
+    void* pArenaTop;
+    KISS_UINT ArenaSize;
+    KISS_UINT NumPrevBytes;
+    KISS_ARENA_BLOCK* pBlock;
+    KISS_UINT Depth;
+} KISS_ARENA_MARK;
+
 /* Create a stack allocator using the provided buffer */
 void KISS_ARENA_Create(KISS_ARENA* pA, void* pBuffer, KISS_UINT Size);
+/* Create an arena that starts with the provided buffer (may be NULL) and obtains geometrically larger
+   blocks from pfnAlloc/pfnFree, or KISS_HEAP_ALLOC/KISS_HEAP_FREE if NULL, when it is exhausted */
+void KISS_ARENA_CreateGrowable(KISS_ARENA* pA, void* pBuffer, KISS_UINT Size, KISS_ARENA_ALLOC_FN pfnAlloc, KISS_ARENA_FREE_FN pfnFree, void* pUser);
 /* Reset the stack allocator to the unallocated state */
 void KISS_ARENA_Delete(KISS_ARENA* pA);
-/* Reset the stack pointer to the bottom of the stack. */
+/* Reset the stack pointer to the bottom of the stack. A growable arena keeps only its largest block */
 void KISS_ARENA_Clear(KISS_ARENA* pA);
 /* Get the number of items pushed onto the stack */
 int KISS_ARENA_BytesAllocated(const KISS_ARENA* pA);
@@ -55,6 +89,11 @@ void* KISS_ARENA_Alloc(KISS_ARENA* pA, KISS_UINT Size);
 
 void* KISS_ARENA_AllocEx(KISS_ARENA* pA, KISS_UINT Size, KISS_UINT Alignment);
 
+/* Capture the current top of the arena */
+void KISS_ARENA_Mark(KISS_ARENA* pA, KISS_ARENA_MARK* pMark);
+/* Release everything allocated since the mark was taken. Nested marks must be rewound innermost first */
+void KISS_ARENA_Rewind(KISS_ARENA* pA, const KISS_ARENA_MARK* pMark);
+
 #ifdef __cplusplus
 }
 #endif
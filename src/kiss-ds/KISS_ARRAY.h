@@ -55,7 +55,7 @@ void* KISS_ARRAY_PutBack(KISS_ARRAY* pARRAY, const void* pItem);
 
 void* KISS_ARRAY_InsertAt(KISS_ARRAY* pARRAY, KISS_INT Position, const void* pItem);
 
-int KISS_ARRAY_Splice(KISS_ARRAY* pARRAY, KISS_INT StartIndex, KISS_UINT DeleteCount, void* pItems, KISS_UINT ItemCount);
+int KISS_ARRAY_Splice(KISS_ARRAY* pARRAY, KISS_INT StartIndex, KISS_UINT DeleteCount, const void* pItems, KISS_UINT ItemCount);
 
 KISS_BOOL KISS_ARRAY_Get(KISS_ARRAY* pARRAY, KISS_INT Position, void* pData);
 KISS_BOOL KISS_ARRAY_GetPtr(KISS_ARRAY* pARRAY, KISS_INT Position, void ** ppElement);
@@ -69,6 +69,127 @@ KISS_UINT KISS_ARRAY_GetItemSize(const KISS_ARRAY* pARRAY);
 KISS_UINT KISS_ARRAY_GetItemCount(const KISS_ARRAY* pARRAY);
 KISS_UINT KISS_ARRAY_GetItemCapacity(const KISS_ARRAY* pARRAY);
 
+/*
+KISS_ARRAY_DEFINE(name, type, capacity) generates an array type called name holding up to
+capacity elements of type, with the storage embedded in the struct, and a set of static inline
+functions name##_Create/Clear/PutFront/PutBack/InsertAt/Get/GetPtr/Erase/Remove/GetItemCount/
+GetItemCapacity with the same semantics as the KISS_ARRAY functions (including negative
+positions). As the element size and capacity are compile time constants each element is moved
+with a plain assignment instead of a KISS_MEMCPY call.
+*/
+#define KISS_ARRAY_DEFINE(name, type, capacity) \
+typedef struct name { \
+    type Items[capacity]; \
+    KISS_UINT Count; \
+} name; \
+typedef char name##_CapacityCheck[((capacity) > 0) ? 1 : -1]; \
+KISS_INLINE void name##_Create(name* pARRAY) { \
+    pARRAY->Count = 0; \
+} \
+KISS_INLINE void name##_Clear(name* pARRAY) { \
+    pARRAY->Count = 0; \
+} \
+KISS_INLINE type* name##_InsertAt(name* pARRAY, KISS_INT Position, const type* pItem) { \
+    if (pARRAY->Count >= (capacity)) { \
+        return NULL; \
+    } \
+    if (Position < 0) { \
+        Position = pARRAY->Count + Position + 1; \
+    } \
+    if (Position >= 0 && Position <= (KISS_INT)pARRAY->Count) { \
+        for (KISS_INT i = (KISS_INT)pARRAY->Count; i > Position; --i) { \
+            pARRAY->Items[i] = pARRAY->Items[i - 1]; \
+        } \
+        pARRAY->Count++; \
+        if (pItem) { \
+            pARRAY->Items[Position] = *pItem; \
+        } \
+        else { \
+            KISS_MEMSET(&pARRAY->Items[Position], 0, sizeof(type)); \
+        } \
+        return &pARRAY->Items[Position]; \
+    } \
+    return NULL; \
+} \
+KISS_INLINE type* name##_PutFront(name* pARRAY, const type* pItem) { \
+    return name##_InsertAt(pARRAY, 0, pItem); \
+} \
+KISS_INLINE type* name##_PutBack(name* pARRAY, const type* pItem) { \
+    if (pARRAY->Count >= (capacity)) { \
+        return NULL; \
+    } \
+    type* pDstItem = &pARRAY->Items[pARRAY->Count++]; \
+    if (pItem) { \
+        *pDstItem = *pItem; \
+    } \
+    else { \
+        KISS_MEMSET(pDstItem, 0, sizeof(type)); \
+    } \
+    return pDstItem; \
+} \
+KISS_INLINE KISS_BOOL name##_GetPtr(name* pARRAY, KISS_INT Position, type** ppElement) { \
+    if (Position < 0) { \
+        Position = pARRAY->Count + Position; \
+    } \
+    /* Bounded by the capacity too so the compiler can prove the access is in range */ \
+    if (Position >= 0 && Position < (KISS_INT)KISS_MIN(pARRAY->Count, (capacity))) { \
+        if (ppElement) { \
+            *ppElement = &pARRAY->Items[Position]; \
+        } \
+        return 0; \
+    } \
+    return 1; \
+} \
+KISS_INLINE KISS_BOOL name##_Get(name* pARRAY, KISS_INT Position, type* pData) { \
+    type* pItem = NULL; \
+    if (name##_GetPtr(pARRAY, Position, &pItem) == 0) { \
+        if (pData) { \
+            *pData = *pItem; \
+        } \
+        return 0; \
+    } \
+    return 1; \
+} \
+KISS_INLINE int name##_Erase(name* pARRAY, KISS_INT Position, KISS_UINT Num) { \
+    if (Position < 0) { \
+        Position = pARRAY->Count + Position; \
+    } \
+    if (Position >= 0 && Position < (KISS_INT)pARRAY->Count) { \
+        Num = KISS_MIN(Num, pARRAY->Count - Position); \
+        for (KISS_UINT i = Position; i + Num < pARRAY->Count; ++i) { \
+            pARRAY->Items[i] = pARRAY->Items[i + Num]; \
+        } \
+        pARRAY->Count -= Num; \
+        KISS_MEMSET(&pARRAY->Items[pARRAY->Count], 0, sizeof(type) * Num); \
+        return pARRAY->Count; \
+    } \
+    return 0; \
+} \
+KISS_INLINE int name##_Remove(name* pARRAY, KISS_INT Position, KISS_UINT Num) { \
+    if (Position < 0) { \
+        Position = pARRAY->Count + Position; \
+    } \
+    if (Position >= 0 && Position < (KISS_INT)pARRAY->Count) { \
+        Num = KISS_MIN(Num, pARRAY->Count - Position); \
+        /* Move the elements at the end of the array which are kept into the hole */ \
+        const KISS_UINT NumMove = KISS_MIN(Num, pARRAY->Count - (Position + Num)); \
+        for (KISS_UINT i = 0; i < NumMove; ++i) { \
+            pARRAY->Items[Position + i] = pARRAY->Items[pARRAY->Count - NumMove + i]; \
+        } \
+        pARRAY->Count -= Num; \
+        KISS_MEMSET(&pARRAY->Items[pARRAY->Count], 0, sizeof(type) * Num); \
+        return pARRAY->Count; \
+    } \
+    return 0; \
+} \
+KISS_INLINE KISS_UINT name##_GetItemCount(const name* pARRAY) { \
+    return pARRAY->Count; \
+} \
+KISS_INLINE KISS_UINT name##_GetItemCapacity(const name* pARRAY) { \
+    (void)pARRAY; \
+    return (capacity); \
+}
+
 
 #ifdef __cplusplus
 }
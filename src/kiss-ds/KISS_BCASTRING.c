@@ -0,0 +1,232 @@
+/*================================================================================
+*   zlib/libpng license
+*
+*   Copyright (c) 2021. Denis Hilliard
+*
+*   This software is provided 'as-is', without any express or implied warranty.
+*    In no event will the authors be held liable for any damages arising from the
+*    use of this software.
+*
+*    Permission is granted to anyone to use this software for any purpose,
+*    including commercial applications, and to alter it and redistribute it
+*    freely, subject to the following restrictions:
+*
+*        1. The origin of this software must not be misrepresented; you must not
+*        claim that you wrote the original software. If you use this software in a
+*        product, an acknowledgment in the product documentation would be
+*        appreciated but is not required.
+*
+*        2. Altered source versions must be plainly marked as such, and must not
+*        be misrepresented as being the original software.
+*
+*        3. This notice may not be removed or altered from any source
+*        distribution.
+*
+*   Component: Broadcast Ring Buffer
+*   File: KISS_BCASTRING.c
+*   Description:  This file implements the logic for a lock-free fixed size ring
+*                 buffer where one producer thread broadcasts every element to
+*                 several consumer threads.
+*   Caution/Notes:  None
+*=================================================================================*/
+#include "KISS_BCASTRING.h"
+
+/* Internal function to find the cursor of the slowest reader */
+static KISS_UINT __min_head(const KISS_BCASTRING* pRB, KISS_UINT oTail);
+
+/* ===============================================================================
+* Name: KISS_BCASTRING_Create()
+* Description: Create a broadcast ring buffer of fixed size items.
+* Parameters:   [O] pRB - Pointer to ring buffer
+*               [I] sizeofMsg - Size of each individual message
+*               [I] maxnofmsg - Number of messages in the buffer. Must be a power of 2.
+*               [I] pBuffer - Pointer to buffer to use for storage
+* Return: None
+* Caution/Notes: Memory pointed to by pBuffer must be at least sizeofMsg * maxnofmsg bytes.
+*                The ring buffer must be created before any thread uses it.
+================================================================================== */
+void KISS_BCASTRING_Create(KISS_BCASTRING* pRB, KISS_UINT16 sizeofMsg, KISS_UINT maxnofmsg, void* pBuffer) {
+    KISS_ASSERT(pRB != NULL, "Ring Buffer must be a valid pointer");
+    KISS_ASSERT(pBuffer != NULL, "Storage buffer must not be NULL");
+    KISS_ASSERT(sizeofMsg > 0, "The size of each individual message cannot be zero");
+    KISS_ASSERT(KISS_IS_POW2(maxnofmsg), "The number of messages must be a power of 2");
+    KISS_MEMSET(pRB, 0, sizeof(KISS_BCASTRING));
+    pRB->pBuffer = pBuffer;
+    pRB->MaxCount = maxnofmsg;
+    pRB->ItemSize = sizeofMsg;
+    pRB->oTail = 0;
+    pRB->oMinHeadCache = 0;
+    pRB->NumReaders = 0;
+}
+
+/* ===============================================================================
+* Name: KISS_BCASTRING_Delete()
+* Description: Clear the ring buffer.
+* Parameters: [I/O] pRB - Pointer to the Ring Buffer
+* Return: None
+* Caution/Notes: No thread may use the ring buffer during or after this call.
+================================================================================== */
+void KISS_BCASTRING_Delete(KISS_BCASTRING* pRB) {
+    KISS_ASSERT(pRB != NULL, "Ring Buffer must be a valid pointer");
+    KISS_MEMSET(pRB, 0, sizeof(KISS_BCASTRING));
+}
+
+/* ===============================================================================
+* Name: KISS_BCASTRING_AddReader()
+* Description: Register a new reader with its own read cursor.
+* Parameters: [I/O] pRB - Pointer to the Ring Buffer
+* Return: int - Id of the new reader, or -1 if KISS_BCASTRING_MAX_READERS are registered.
+* Caution/Notes: The reader starts at the tail seen once it is registered and receives
+*                every element put afterwards. May be called while the producer is
+*                running, but not concurrently with another call to KISS_BCASTRING_AddReader()
+*                or with the new reader's own Get calls.
+================================================================================== */
+int KISS_BCASTRING_AddReader(KISS_BCASTRING* pRB) {
+    KISS_ASSERT(pRB != NULL, "Ring Buffer must be a valid pointer");
+    const KISS_UINT Id = pRB->NumReaders;
+    if (Id < KISS_BCASTRING_MAX_READERS) {
+        KISS_BCASTRING_READER* pReader = &pRB->Readers[Id];
+        pReader->oHead = KISS_ATOMIC_LOAD(&pRB->oTail);
+        /* Publish the cursor before the producer can take it into account */
+        KISS_ATOMIC_STORE(&pRB->NumReaders, Id + 1);
+        /* A producer that scanned the readers before the store may have overwritten the
+           slots behind the cursor since. Pairs with the fence in __min_head(): either the
+           producer sees the reader or this load sees the tail the producer scanned at */
+        KISS_ATOMIC_FENCE();
+        const KISS_UINT oTail = KISS_ATOMIC_LOAD(&pRB->oTail);
+        pReader->oTailCache = oTail;
+        KISS_ATOMIC_STORE(&pReader->oHead, oTail);
+        return (int)Id;
+    }
+    return -1;
+}
+
+/* ===============================================================================
+* Name: KISS_BCASTRING_Put()
+* Description:  Put the element to the end of the ring buffer, making it visible to all readers.
+* Parameters:   [I/O] pRB - Pointer to ring buffer
+*               [I] pElement - Pointer to the element to add at the back of the ring buffer.
+* Return: KISS_BOOL - Returns 0 on success, non-zero if the slowest reader has not
+*                     consumed the oldest element yet.
+* Caution/Notes: Must only be called from the producer thread.
+*                Ownership of pElement is borrowed until function returns.
+================================================================================== */
+KISS_BOOL KISS_BCASTRING_Put(KISS_BCASTRING* pRB, const void* pElement) {
+    KISS_ASSERT(pRB != NULL, "Ring Buffer must be a valid pointer");
+    const KISS_UINT oTail = KISS_ATOMIC_LOAD_RELAXED(&pRB->oTail);
+
+    if (oTail - pRB->oMinHeadCache >= pRB->MaxCount) {
+        /* Looks full: refresh the cached cursor of the slowest reader */
+        pRB->oMinHeadCache = __min_head(pRB, oTail);
+        if (oTail - pRB->oMinHeadCache >= pRB->MaxCount) {
+            return 1;
+        }
+    }
+    void* pDest = &pRB->pBuffer[(oTail & (pRB->MaxCount - 1)) * pRB->ItemSize];
+    KISS_MEMCPY(pDest, pElement, pRB->ItemSize);
+    /* Publish the element to the readers */
+    KISS_ATOMIC_STORE(&pRB->oTail, oTail + 1);
+    return 0;
+}
+
+/* ===============================================================================
+* Name: KISS_BCASTRING_Get()
+* Description: Get the next element for the reader. Will copy data into supplied buffer
+* Parameters:   [I/O] pRB - Pointer to the ring buffer.
+*               [I] ReaderId - Id returned by KISS_BCASTRING_AddReader()
+*               [O] pData - Pointer to memory to receive the element.
+* Return: KISS_BOOL - Returns 0 on success
+* Caution/Notes: Must only be called from the thread owning ReaderId.
+*                The memory pointed to by pData should be at least ItemSize bytes long
+================================================================================== */
+KISS_BOOL KISS_BCASTRING_Get(KISS_BCASTRING* pRB, int ReaderId, void* pData) {
+    void* pSrc = NULL;
+    if (pData != NULL && KISS_BCASTRING_GetPtr(pRB, ReaderId, &pSrc) == 0) {
+        KISS_MEMCPY(pData, pSrc, pRB->ItemSize);
+        KISS_BCASTRING_Purge(pRB, ReaderId);
+        return 0;
+    }
+    return 1;
+}
+
+/* ===============================================================================
+* Name: KISS_BCASTRING_GetPtr()
+* Description: Get a pointer to the next element for the reader.
+* Parameters: [I] pRB - Pointer to the ring buffer
+*             [I] ReaderId - Id returned by KISS_BCASTRING_AddReader()
+*             [O] ppDest - Pointer to pointer to the element.
+* Return: KISS_BOOL - Returns 0 on success
+* Caution/Notes: Must only be called from the thread owning ReaderId. The element
+*                remains valid until KISS_BCASTRING_Purge() is called.
+================================================================================== */
+KISS_BOOL KISS_BCASTRING_GetPtr(KISS_BCASTRING* pRB, int ReaderId, void** ppDest) {
+    KISS_ASSERT(pRB != NULL, "Ring Buffer must be a valid pointer");
+    KISS_ASSERT(ReaderId >= 0 && (KISS_UINT)ReaderId < KISS_ATOMIC_LOAD_RELAXED(&pRB->NumReaders), "Reader id is invalid");
+    KISS_BCASTRING_READER* pReader = &pRB->Readers[ReaderId];
+    const KISS_UINT oHead = KISS_ATOMIC_LOAD_RELAXED(&pReader->oHead);
+
+    if (ppDest != NULL) {
+        if (oHead == pReader->oTailCache) {
+            /* Looks empty: refresh the cached tail from the producer's cache line */
+            pReader->oTailCache = KISS_ATOMIC_LOAD(&pRB->oTail);
+            if (oHead == pReader->oTailCache) {
+                return 1;
+            }
+        }
+        *ppDest = &pRB->pBuffer[(oHead & (pRB->MaxCount - 1)) * pRB->ItemSize];
+        return 0;
+    }
+    return 1;
+}
+
+/* ===============================================================================
+* Name: KISS_BCASTRING_Purge()
+* Description: Advance the reader past its current element. Used in conjunction with KISS_BCASTRING_GetPtr()
+* Parameters: [I/O] pRB - Pointer to the ring buffer
+*             [I] ReaderId - Id returned by KISS_BCASTRING_AddReader()
+* Return: None
+* Caution/Notes: Must only be called from the thread owning ReaderId after a
+*                successful call to KISS_BCASTRING_GetPtr().
+================================================================================== */
+void KISS_BCASTRING_Purge(KISS_BCASTRING* pRB, int ReaderId) {
+    KISS_ASSERT(pRB != NULL, "Ring Buffer must be a valid pointer");
+    KISS_ASSERT(ReaderId >= 0 && (KISS_UINT)ReaderId < KISS_ATOMIC_LOAD_RELAXED(&pRB->NumReaders), "Reader id is invalid");
+    KISS_BCASTRING_READER* pReader = &pRB->Readers[ReaderId];
+    const KISS_UINT oHead = KISS_ATOMIC_LOAD_RELAXED(&pReader->oHead);
+    if (oHead != pReader->oTailCache) {
+        /* Release the slot to the producer once every reader has moved past it */
+        KISS_ATOMIC_STORE(&pReader->oHead, oHead + 1);
+    }
+}
+
+/* ===============================================================================
+* Name: KISS_BCASTRING_GetItemCnt()
+* Description: Get the number of elements the reader has still to consume.
+* Parameters: [I] pRB - Pointer to the ring buffer
+*             [I] ReaderId - Id returned by KISS_BCASTRING_AddReader()
+* Return: int - Number of pending elements for the reader
+* Caution/Notes: The result is only a snapshot if other threads are active.
+================================================================================== */
+int KISS_BCASTRING_GetItemCnt(const KISS_BCASTRING* pRB, int ReaderId) {
+    KISS_ASSERT(pRB != NULL, "Ring Buffer must be a valid pointer");
+    KISS_ASSERT(ReaderId >= 0 && (KISS_UINT)ReaderId < KISS_ATOMIC_LOAD_RELAXED(&pRB->NumReaders), "Reader id is invalid");
+    const KISS_UINT oHead = KISS_ATOMIC_LOAD(&pRB->Readers[ReaderId].oHead);
+    const KISS_UINT oTail = KISS_ATOMIC_LOAD(&pRB->oTail);
+    return (int)KISS_MIN(oTail - oHead, pRB->MaxCount);
+}
+
+static KISS_UINT __min_head(const KISS_BCASTRING* pRB, KISS_UINT oTail) {
+    /* Order the tail store before the scan, see KISS_BCASTRING_AddReader(). Only taken
+       when the ring appears full */
+    KISS_ATOMIC_FENCE();
+    const KISS_UINT NumReaders = KISS_ATOMIC_LOAD(&pRB->NumReaders);
+    /* Without readers nothing holds the producer back */
+    KISS_UINT oMinHead = oTail;
+    for (KISS_UINT i = 0; i < NumReaders; ++i) {
+        const KISS_UINT oHead = KISS_ATOMIC_LOAD(&pRB->Readers[i].oHead);
+        if ((KISS_INT)(oHead - oMinHead) < 0) {
+            oMinHead = oHead;
+        }
+    }
+    return oMinHead;
+}
@@ -0,0 +1,97 @@
+/*================================================================================
+*   zlib/libpng license
+*
+*   Copyright (c) 2021. Denis Hilliard
+*
+*   This software is provided 'as-is', without any express or implied warranty.
+*    In no event will the authors be held liable for any damages arising from the
+*    use of this software.
+*
+*    Permission is granted to anyone to use this software for any purpose,
+*    including commercial applications, and to alter it and redistribute it
+*    freely, subject to the following restrictions:
+*
+*        1. The origin of this software must not be misrepresented; you must not
+*        claim that you wrote the original software. If you use this software in a
+*        product, an acknowledgment in the product documentation would be
+*        appreciated but is not required.
+*
+*        2. Altered source versions must be plainly marked as such, and must not
+*        be misrepresented as being the original software.
+*
+*        3. This notice may not be removed or altered from any source
+*        distribution.
+*
+*   Component: Broadcast Ring Buffer
+*   File: KISS_BCASTRING.h
+*   Description:  This file implements the logic for a lock-free fixed size ring
+*                 buffer where one producer thread broadcasts every element to
+*                 several consumer threads.
+*   Caution/Notes:  None
+*=================================================================================*/
+#ifndef _KISS_BCASTRING_H_
+#define _KISS_BCASTRING_H_
+
+#include "KISS_Common.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Maximum number of readers which can be registered with a broadcast ring buffer */
+#ifndef KISS_BCASTRING_MAX_READERS
+#define KISS_BCASTRING_MAX_READERS 8
+#endif
+
+/* Read cursor of a single consumer. Each cursor lives on its own cache line */
+typedef struct {
+    KISS_UINT oHead;
+    KISS_UINT oTailCache;
+    uint8_t Pad[KISS_CACHELINE_SIZE - 2 * sizeof(KISS_UINT)];
+} KISS_BCASTRING_READER;
+
+/*
+KISS_BCASTRING implements a ring buffer for fixed size messages where the producer writes each
+element once and every registered reader consumes it through its own read cursor (disruptor style).
+The producer is only held back by the slowest reader, and keeps a cached copy of the slowest
+cursor so the readers' cache lines are only scanned when the ring appears full.
+Indices run freely and MaxCount must be a power of 2.
+*/
+typedef struct {
+    /* Read-only after creation */
+    uint8_t* pBuffer;
+    KISS_UINT MaxCount;
+    KISS_UINT16 ItemSize;
+    uint8_t Pad0[KISS_CACHELINE_SIZE];
+    /* Written by the producer only */
+    KISS_UINT oTail;
+    KISS_UINT oMinHeadCache;
+    uint8_t Pad1[KISS_CACHELINE_SIZE - 2 * sizeof(KISS_UINT)];
+    /* Written by KISS_BCASTRING_AddReader() */
+    KISS_UINT NumReaders;
+    uint8_t Pad2[KISS_CACHELINE_SIZE - sizeof(KISS_UINT)];
+    KISS_BCASTRING_READER Readers[KISS_BCASTRING_MAX_READERS];
+} KISS_BCASTRING;
+
+/* Create a broadcast ring buffer using the buffer as the backing storage. maxnofmsg must be a power of 2 */
+void KISS_BCASTRING_Create(KISS_BCASTRING* pRB, KISS_UINT16 sizeofMsg, KISS_UINT maxnofmsg, void* pBuffer);
+/* Clear the ring buffer to the uninitialised state */
+void KISS_BCASTRING_Delete(KISS_BCASTRING* pRB);
+/* Register a new reader, which receives every element put after this call. Returns the reader id or -1 */
+int KISS_BCASTRING_AddReader(KISS_BCASTRING* pRB);
+/* Get the number of items the reader has still to consume. Only a snapshot when called concurrently. */
+int KISS_BCASTRING_GetItemCnt(const KISS_BCASTRING* pRB, int ReaderId);
+
+/* Producer side. Returns 0 on success */
+KISS_BOOL KISS_BCASTRING_Put(KISS_BCASTRING* pRB, const void* pElement);
+
+/* Consumer side, one thread per reader id. These functions all return 0 on success */
+KISS_BOOL KISS_BCASTRING_Get(KISS_BCASTRING* pRB, int ReaderId, void* pData);
+KISS_BOOL KISS_BCASTRING_GetPtr(KISS_BCASTRING* pRB, int ReaderId, void** ppDest);
+/* Must be used with KISS_BCASTRING_GetPtr() to advance the reader past the element */
+void KISS_BCASTRING_Purge(KISS_BCASTRING* pRB, int ReaderId);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
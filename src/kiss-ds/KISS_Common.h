@@ -38,6 +38,10 @@
 #include <memory.h>
 #define KISS_MEMCPY(dst, src, size) memcpy((dst), (src), size)
 #endif
+#ifndef KISS_MEMMOVE
+#include <memory.h>
+#define KISS_MEMMOVE(dst, src, size) memmove((dst), (src), size)
+#endif
 #ifndef KISS_HEAP_ALLOC
 #include <stdlib.h>
 #define KISS_HEAP_ALLOC(size) malloc(size)
@@ -56,6 +60,44 @@
 #define KISS_ASSERT(cond, msg) assert((cond) && (msg));
 #endif
 
+/* Macros for atomic operations used by the concurrent data structures.
+   LOAD has acquire semantics, STORE has release semantics.
+   CAS and FETCH_ADD are full barriers. CAS evaluates to non-zero if *p was changed
+   from e to v, FETCH_ADD evaluates to the previous value of *p. */
+#ifndef KISS_ATOMIC_LOAD
+#if defined(_MSC_VER)
+#include <intrin.h>
+/* MSVC (/volatile:ms) gives volatile accesses acquire/release semantics */
+#define KISS_ATOMIC_LOAD(p) (*(volatile KISS_UINT*)(p))
+#define KISS_ATOMIC_LOAD_RELAXED(p) (*(volatile KISS_UINT*)(p))
+#define KISS_ATOMIC_STORE(p, v) (*(volatile KISS_UINT*)(p) = (v))
+#define KISS_ATOMIC_CAS(p, e, v) (_InterlockedCompareExchange((volatile long*)(p), (long)(v), (long)(e)) == (long)(e))
+#define KISS_ATOMIC_FETCH_ADD(p, v) ((KISS_UINT)_InterlockedExchangeAdd((volatile long*)(p), (long)(v)))
+#define KISS_ATOMIC_FENCE() _mm_mfence()
+#else
+#define KISS_ATOMIC_LOAD(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define KISS_ATOMIC_LOAD_RELAXED(p) __atomic_load_n((p), __ATOMIC_RELAXED)
+#define KISS_ATOMIC_STORE(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#define KISS_ATOMIC_CAS(p, e, v) __sync_bool_compare_and_swap((p), (e), (v))
+#define KISS_ATOMIC_FETCH_ADD(p, v) __atomic_fetch_add((p), (v), __ATOMIC_SEQ_CST)
+#define KISS_ATOMIC_FENCE() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#endif
+#endif
+
+/* Size of a cache line. Used to pad data shared between threads to avoid false sharing */
+#ifndef KISS_CACHELINE_SIZE
+#define KISS_CACHELINE_SIZE 64
+#endif
+
+/* Storage class for the functions generated by the KISS_*_DEFINE() macros */
+#ifndef KISS_INLINE
+#if defined(_MSC_VER)
+#define KISS_INLINE static __inline
+#else
+#define KISS_INLINE static inline
+#endif
+#endif
+
 /* Helper macros for simple math */
 #define KISS_MAX(a,b) ((a) >= (b) ? (a) : (b))
 #define KISS_MIN(a,b) ((a) <= (b) ? (a) : (b))
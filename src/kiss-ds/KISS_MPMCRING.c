@@ -0,0 +1,173 @@
+/*================================================================================
+*   zlib/libpng license
+*
+*   Copyright (c) 2021. Denis Hilliard
+*
+*   This software is provided 'as-is', without any express or implied warranty.
+*    In no event will the authors be held liable for any damages arising from the
+*    use of this software.
+*
+*    Permission is granted to anyone to use this software for any purpose,
+*    including commercial applications, and to alter it and redistribute it
+*    freely, subject to the following restrictions:
+*
+*        1. The origin of this software must not be misrepresented; you must not
+*        claim that you wrote the original software. If you use this software in a
+*        product, an acknowledgment in the product documentation would be
+*        appreciated but is not required.
+*
+*        2. Altered source versions must be plainly marked as such, and must not
+*        be misrepresented as being the original software.
+*
+*        3. This notice may not be removed or altered from any source
+*        distribution.
+*
+*   Component: Multi Producer/Multi Consumer Ring Buffer
+*   File: KISS_MPMCRING.c
+*   Description:  This file implements the logic for a bounded lock-free fixed size
+*                 ring buffer shared between any number of producer and consumer threads.
+*   Caution/Notes:  None
+*=================================================================================*/
+#include "KISS_MPMCRING.h"
+
+/* Internal function to get the sequence number of the slot used by position o */
+static KISS_UINT* __slot_seq(const KISS_MPMCRING* pRB, KISS_UINT o);
+
+/* ===============================================================================
+* Name: KISS_MPMCRING_Create()
+* Description: Create a multi producer/multi consumer ring buffer of fixed size items.
+* Parameters:   [O] pRB - Pointer to ring buffer
+*               [I] sizeofMsg - Size of each individual message
+*               [I] maxnofmsg - Number of messages in the buffer. Must be a power of 2.
+*               [I] pBuffer - Pointer to buffer to use for storage
+* Return: None
+* Caution/Notes: Memory pointed to by pBuffer must be at least
+*                KISS_MPMCRING_BUFFER_SIZE(sizeofMsg, maxnofmsg) bytes and aligned
+*                to sizeof(KISS_UINT). The ring buffer must be created before any
+*                thread uses it.
+================================================================================== */
+void KISS_MPMCRING_Create(KISS_MPMCRING* pRB, KISS_UINT16 sizeofMsg, KISS_UINT maxnofmsg, void* pBuffer) {
+    KISS_ASSERT(pRB != NULL, "Ring Buffer must be a valid pointer");
+    KISS_ASSERT(pBuffer != NULL, "Storage buffer must not be NULL");
+    KISS_ASSERT(KISS_ALIGN_DOWN_PTR(pBuffer, sizeof(KISS_UINT)) == pBuffer, "Storage buffer must be aligned to sizeof(KISS_UINT)");
+    KISS_ASSERT(sizeofMsg > 0, "The size of each individual message cannot be zero");
+    KISS_ASSERT(KISS_IS_POW2(maxnofmsg), "The number of messages must be a power of 2");
+    KISS_MEMSET(pRB, 0, sizeof(KISS_MPMCRING));
+    pRB->pBuffer = pBuffer;
+    pRB->MaxCount = maxnofmsg;
+    pRB->ItemSize = sizeofMsg;
+    pRB->SlotSize = KISS_ALIGN_UP(sizeof(KISS_UINT) + sizeofMsg, sizeof(KISS_UINT));
+    pRB->oEnqueue = 0;
+    pRB->oDequeue = 0;
+    /* Slot i is ready to be written at position i */
+    for (KISS_UINT i = 0; i < maxnofmsg; ++i) {
+        *__slot_seq(pRB, i) = i;
+    }
+}
+
+/* ===============================================================================
+* Name: KISS_MPMCRING_Delete()
+* Description: Clear the ring buffer.
+* Parameters: [I/O] pRB - Pointer to the Ring Buffer
+* Return: None
+* Caution/Notes: No thread may use the ring buffer during or after this call.
+================================================================================== */
+void KISS_MPMCRING_Delete(KISS_MPMCRING* pRB) {
+    KISS_ASSERT(pRB != NULL, "Ring Buffer must be a valid pointer");
+    pRB->pBuffer = NULL;
+    pRB->MaxCount = 0;
+    pRB->ItemSize = 0;
+    pRB->SlotSize = 0;
+    pRB->oEnqueue = 0;
+    pRB->oDequeue = 0;
+}
+
+/* ===============================================================================
+* Name: KISS_MPMCRING_Put()
+* Description:  Put the element to the end of the ring buffer.
+* Parameters:   [I/O] pRB - Pointer to ring buffer
+*               [I] pElement - Pointer to the element to add at the back of the ring buffer.
+* Return: KISS_BOOL - Returns 0 on success
+* Caution/Notes: Ownership of pElement is borrowed until function returns.
+================================================================================== */
+KISS_BOOL KISS_MPMCRING_Put(KISS_MPMCRING* pRB, const void* pElement) {
+    KISS_ASSERT(pRB != NULL, "Ring Buffer must be a valid pointer");
+    KISS_UINT oPos = KISS_ATOMIC_LOAD_RELAXED(&pRB->oEnqueue);
+    KISS_UINT* pSeq;
+
+    for (;;) {
+        pSeq = __slot_seq(pRB, oPos);
+        const KISS_INT Diff = (KISS_INT)(KISS_ATOMIC_LOAD(pSeq) - oPos);
+        if (Diff == 0) {
+            /* The slot is free: try to claim it */
+            if (KISS_ATOMIC_CAS(&pRB->oEnqueue, oPos, oPos + 1)) {
+                break;
+            }
+        }
+        else if (Diff < 0) {
+            /* The slot still holds an item from the previous lap: ring is full */
+            return 1;
+        }
+        oPos = KISS_ATOMIC_LOAD_RELAXED(&pRB->oEnqueue);
+    }
+    KISS_MEMCPY(pSeq + 1, pElement, pRB->ItemSize);
+    /* Publish the element to the consumers */
+    KISS_ATOMIC_STORE(pSeq, oPos + 1);
+    return 0;
+}
+
+/* ===============================================================================
+* Name: KISS_MPMCRING_Get()
+* Description: Get the top most element of the ring buffer. Will copy data into supplied buffer
+* Parameters:   [I/O] pRB - Pointer to the ring buffer.
+*               [O] pData - Pointer to memory to receive the top most element.
+* Return: KISS_BOOL - Returns 0 on success
+* Caution/Notes: The memory pointed to by pData should be at least ItemSize bytes long
+================================================================================== */
+KISS_BOOL KISS_MPMCRING_Get(KISS_MPMCRING* pRB, void* pData) {
+    KISS_ASSERT(pRB != NULL, "Ring Buffer must be a valid pointer");
+    KISS_UINT oPos = KISS_ATOMIC_LOAD_RELAXED(&pRB->oDequeue);
+    KISS_UINT* pSeq;
+
+    if (pData == NULL) {
+        return 1;
+    }
+    for (;;) {
+        pSeq = __slot_seq(pRB, oPos);
+        const KISS_INT Diff = (KISS_INT)(KISS_ATOMIC_LOAD(pSeq) - (oPos + 1));
+        if (Diff == 0) {
+            /* The slot has been published: try to claim it */
+            if (KISS_ATOMIC_CAS(&pRB->oDequeue, oPos, oPos + 1)) {
+                break;
+            }
+        }
+        else if (Diff < 0) {
+            /* The slot has not been written yet: ring is empty */
+            return 1;
+        }
+        oPos = KISS_ATOMIC_LOAD_RELAXED(&pRB->oDequeue);
+    }
+    KISS_MEMCPY(pData, pSeq + 1, pRB->ItemSize);
+    /* Hand the slot back to the producers for the next lap */
+    KISS_ATOMIC_STORE(pSeq, oPos + pRB->MaxCount);
+    return 0;
+}
+
+/* ===============================================================================
+* Name: KISS_MPMCRING_GetItemCnt()
+* Description: Get the number of elements in the ring buffer.
+* Parameters: [I] pRB - Pointer to the ring buffer
+* Return: int - Number of elements in the ring buffer
+* Caution/Notes: The result is only a snapshot if other threads are active.
+================================================================================== */
+int KISS_MPMCRING_GetItemCnt(const KISS_MPMCRING* pRB) {
+    KISS_ASSERT(pRB != NULL, "Ring Buffer must be a valid pointer");
+    const KISS_UINT oDequeue = KISS_ATOMIC_LOAD(&pRB->oDequeue);
+    const KISS_UINT oEnqueue = KISS_ATOMIC_LOAD(&pRB->oEnqueue);
+    const KISS_INT Count = (KISS_INT)(oEnqueue - oDequeue);
+    return KISS_CLAMP(0, Count, (KISS_INT)pRB->MaxCount);
+}
+
+static KISS_UINT* __slot_seq(const KISS_MPMCRING* pRB, KISS_UINT o) {
+    return (KISS_UINT*)&pRB->pBuffer[(o & (pRB->MaxCount - 1)) * pRB->SlotSize];
+}
@@ -0,0 +1,79 @@
+/*================================================================================
+*   zlib/libpng license
+*
+*   Copyright (c) 2021. Denis Hilliard
+*
+*   This software is provided 'as-is', without any express or implied warranty.
+*    In no event will the authors be held liable for any damages arising from the
+*    use of this software.
+*
+*    Permission is granted to anyone to use this software for any purpose,
+*    including commercial applications, and to alter it and redistribute it
+*    freely, subject to the following restrictions:
+*
+*        1. The origin of this software must not be misrepresented; you must not
+*        claim that you wrote the original software. If you use this software in a
+*        product, an acknowledgment in the product documentation would be
+*        appreciated but is not required.
+*
+*        2. Altered source versions must be plainly marked as such, and must not
+*        be misrepresented as being the original software.
+*
+*        3. This notice may not be removed or altered from any source
+*        distribution.
+*
+*   Component: Multi Producer/Multi Consumer Ring Buffer
+*   File: KISS_MPMCRING.h
+*   Description:  This file implements the logic for a bounded lock-free fixed size
+*                 ring buffer shared between any number of producer and consumer threads.
+*   Caution/Notes:  None
+*=================================================================================*/
+#ifndef _KISS_MPMCRING_H_
+#define _KISS_MPMCRING_H_
+
+#include "KISS_Common.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+/*
+KISS_MPMCRING implements a bounded ring buffer for fixed size messages which can be used
+concurrently by multiple producers and multiple consumers without locking.
+Each slot is prefixed with a sequence number. Producers and consumers claim a slot with
+a CAS on the enqueue/dequeue position and the slot sequence number tells whether the slot
+is ready to be written or read (D. Vyukov's bounded MPMC queue).
+*/
+typedef struct {
+    /* Read-only after creation */
+    uint8_t* pBuffer;
+    KISS_UINT MaxCount;
+    KISS_UINT SlotSize;
+    KISS_UINT16 ItemSize;
+    uint8_t Pad0[KISS_CACHELINE_SIZE];
+    /* Shared between producers */
+    KISS_UINT oEnqueue;
+    uint8_t Pad1[KISS_CACHELINE_SIZE - sizeof(KISS_UINT)];
+    /* Shared between consumers */
+    KISS_UINT oDequeue;
+    uint8_t Pad2[KISS_CACHELINE_SIZE - sizeof(KISS_UINT)];
+} KISS_MPMCRING;
+
+/* Size (in bytes) of the storage required for maxnofmsg messages of sizeofMsg bytes */
+#define KISS_MPMCRING_BUFFER_SIZE(sizeofMsg, maxnofmsg) \
+    ((size_t)KISS_ALIGN_UP(sizeof(KISS_UINT) + (sizeofMsg), sizeof(KISS_UINT)) * (maxnofmsg))
+
+/* Create a ring buffer using the buffer as the backing storage. maxnofmsg must be a power of 2 */
+void KISS_MPMCRING_Create(KISS_MPMCRING* pRB, KISS_UINT16 sizeofMsg, KISS_UINT maxnofmsg, void* pBuffer);
+/* Clear the ring buffer to the uninitialised state */
+void KISS_MPMCRING_Delete(KISS_MPMCRING* pRB);
+/* Get the number of items currently in the ring buffer. Only a snapshot when called concurrently. */
+int KISS_MPMCRING_GetItemCnt(const KISS_MPMCRING* pRB);
+
+/* These functions all return 0 on success */
+KISS_BOOL KISS_MPMCRING_Put(KISS_MPMCRING* pRB, const void* pElement);
+KISS_BOOL KISS_MPMCRING_Get(KISS_MPMCRING* pRB, void* pData);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,246 @@
+/*================================================================================
+*   zlib/libpng license
+*
+*   Copyright (c) 2021. Denis Hilliard
+*
+*   This software is provided 'as-is', without any express or implied warranty.
+*    In no event will the authors be held liable for any damages arising from the
+*    use of this software.
+*
+*    Permission is granted to anyone to use this software for any purpose,
+*    including commercial applications, and to alter it and redistribute it
+*    freely, subject to the following restrictions:
+*
+*        1. The origin of this software must not be misrepresented; you must not
+*        claim that you wrote the original software. If you use this software in a
+*        product, an acknowledgment in the product documentation would be
+*        appreciated but is not required.
+*
+*        2. Altered source versions must be plainly marked as such, and must not
+*        be misrepresented as being the original software.
+*
+*        3. This notice may not be removed or altered from any source
+*        distribution.
+*
+*   Component: Multi Producer/Single Consumer Queue
+*   File: KISS_MPSCQUEUE.c
+*   Description:  This file implements the logic for a lock-free queue of variable
+*                 size elements written by many producer threads and read by one
+*                 consumer thread.
+*   Caution/Notes:  None
+*=================================================================================*/
+#include "KISS_MPSCQUEUE.h"
+
+typedef struct {
+    KISS_UINT oNext; /* Free running offset of the next record */
+    KISS_UINT SizeFlags; /* Payload size and KISS_MPSCQUEUE_* flags. Written last */
+} KISS_MPSCQUEUE_ITEM;
+
+/* The record has been published by its producer */
+#define KISS_MPSCQUEUE_READY 0x80000000
+/* The record only pads the end of the buffer and holds no data */
+#define KISS_MPSCQUEUE_PAD 0x40000000
+
+/* Internal function to get the header of the record starting at the free running offset o */
+static KISS_MPSCQUEUE_ITEM* __item(const KISS_MPSCQUEUE* pQ, KISS_UINT o);
+
+/* ===============================================================================
+* Name: KISS_MPSCQUEUE_Create()
+* Description: Initialise the queue with a fixed size / preallocated memory buffer
+* Parameters:   [O] pQ - Pointer to the queue to initialise
+*               [I] pData - Pointer to buffer to use for queue storage
+*               [I] Size - Size of the buffer in bytes. Must be a power of 2.
+* Return: None
+* Caution/Notes: pData must be aligned to KISS_MPSCQUEUE_ALIGN. The buffer is zeroed.
+*                The queue must be created before any thread uses it.
+================================================================================== */
+void KISS_MPSCQUEUE_Create(KISS_MPSCQUEUE* pQ, void* pData, KISS_UINT Size) {
+    KISS_ASSERT(pQ != NULL, "Queue must be a valid pointer");
+    KISS_ASSERT(pData != NULL, "Storage buffer must not be NULL");
+    KISS_ASSERT(((uintptr_t)pData % KISS_MPSCQUEUE_ALIGN) == 0, "Storage buffer is not aligned");
+    KISS_ASSERT(KISS_IS_POW2(Size) && Size >= KISS_MPSCQUEUE_ALIGN, "The size must be a power of 2");
+    KISS_MEMSET(pQ, 0, sizeof(KISS_MPSCQUEUE));
+    /* Producers rely on the headers of unused space never looking published */
+    KISS_MEMSET(pData, 0, Size);
+    pQ->pBuffer = pData;
+    pQ->TotalSize = Size;
+    pQ->oHead = 0;
+    pQ->oTail = 0;
+}
+
+/* ===============================================================================
+* Name: KISS_MPSCQUEUE_Delete()
+* Description: Deallocate the queue
+* Parameters:   [O] pQ - Pointer to the queue to deallocate
+* Return: None
+* Caution/Notes: No thread may use the queue during or after this call.
+================================================================================== */
+void KISS_MPSCQUEUE_Delete(KISS_MPSCQUEUE* pQ) {
+    KISS_ASSERT(pQ != NULL, "Queue must be a valid pointer");
+    KISS_MEMSET(pQ, 0, sizeof(KISS_MPSCQUEUE));
+}
+
+/* ===============================================================================
+* Name: KISS_MPSCQUEUE_Put()
+* Description: Put an item to the end of the queue.
+* Parameters: [I/O] pQ - Pointer to the queue to modify
+*               [I] pSrc - Pointer to data to add to queue
+*               [I] Size - Size of data to add to queue
+* Return: int - Returns 0 on success, non-zero if the queue has no room for the item.
+* Caution/Notes: May be called from any number of threads.
+================================================================================== */
+int KISS_MPSCQUEUE_Put(KISS_MPSCQUEUE* pQ, const void* pSrc, KISS_UINT Size) {
+    void* pDest = KISS_MPSCQUEUE_Alloc(pQ, Size);
+    if (pDest != NULL) {
+        KISS_MEMCPY(pDest, pSrc, Size);
+        KISS_MPSCQUEUE_Commit(pQ, pDest);
+        return 0;
+    }
+    return 1;
+}
+
+/* ===============================================================================
+* Name: KISS_MPSCQUEUE_Alloc()
+* Description: Reserve space for an item at the end of the queue so it can be built in place.
+* Parameters:   [I/O] pQ - Pointer to the queue to modify
+*               [I] Size - Size of the item.
+* Return: void* - Pointer to the payload of the reserved item, or NULL if the queue
+*                 has no room for it.
+* Caution/Notes: May be called from any number of threads. The consumer stops at the
+*                reserved item until KISS_MPSCQUEUE_Commit() is called, so the item
+*                should be committed promptly.
+================================================================================== */
+void* KISS_MPSCQUEUE_Alloc(KISS_MPSCQUEUE* pQ, KISS_UINT Size) {
+    KISS_ASSERT(pQ != NULL, "Queue must be a valid pointer");
+    if (Size > KISS_MPSCQUEUE_MAX_ITEM_SIZE || Size > pQ->TotalSize) {
+        return NULL;
+    }
+    const KISS_UINT Need = KISS_ALIGN_UP(sizeof(KISS_MPSCQUEUE_ITEM) + Size, KISS_MPSCQUEUE_ALIGN);
+    if (Need > pQ->TotalSize) {
+        return NULL;
+    }
+
+    KISS_UINT oTail;
+    KISS_UINT NumPad;
+    do {
+        /* Load the head first: the consumer never passes a tail loaded afterwards,
+           whereas a stale tail could be passed and oTail - oHead would underflow */
+        const KISS_UINT oHead = KISS_ATOMIC_LOAD(&pQ->oHead);
+        oTail = KISS_ATOMIC_LOAD(&pQ->oTail);
+        const KISS_UINT oSlot = oTail & (pQ->TotalSize - 1);
+        /* A record never crosses the end of the buffer */
+        NumPad = (Need > pQ->TotalSize - oSlot) ? pQ->TotalSize - oSlot : 0;
+        if ((oTail - oHead) + NumPad + Need > pQ->TotalSize) {
+            return NULL;
+        }
+    } while (!KISS_ATOMIC_CAS(&pQ->oTail, oTail, oTail + NumPad + Need));
+
+    if (NumPad > 0) {
+        /* Tell the consumer to skip the end of the buffer */
+        KISS_MPSCQUEUE_ITEM* pPad = __item(pQ, oTail);
+        pPad->oNext = oTail + NumPad;
+        KISS_ATOMIC_STORE(&pPad->SizeFlags, KISS_MPSCQUEUE_READY | KISS_MPSCQUEUE_PAD);
+        oTail += NumPad;
+    }
+    KISS_MPSCQUEUE_ITEM* pItem = __item(pQ, oTail);
+    pItem->oNext = oTail + Need;
+    /* The size is stored without the ready flag, so the consumer still stops here */
+    KISS_ATOMIC_STORE(&pItem->SizeFlags, Size);
+    return (uint8_t*)pItem + sizeof(KISS_MPSCQUEUE_ITEM);
+}
+
+/* ===============================================================================
+* Name: KISS_MPSCQUEUE_Commit()
+* Description: Publish an item reserved by KISS_MPSCQUEUE_Alloc() to the consumer.
+* Parameters:   [I/O] pQ - Pointer to the queue to modify
+*               [I] pData - Payload pointer returned by KISS_MPSCQUEUE_Alloc().
+* Return: None
+* Caution/Notes: Must be called by the thread which reserved the item.
+================================================================================== */
+void KISS_MPSCQUEUE_Commit(KISS_MPSCQUEUE* pQ, void* pData) {
+    KISS_ASSERT(pQ != NULL, "Queue must be a valid pointer");
+    KISS_ASSERT(pData != NULL, "Item must be a valid pointer");
+    /* The queue is only needed for the assertion */
+    (void)pQ;
+    KISS_MPSCQUEUE_ITEM* pItem = (KISS_MPSCQUEUE_ITEM*)((uint8_t*)pData - sizeof(KISS_MPSCQUEUE_ITEM));
+    const KISS_UINT SizeFlags = KISS_ATOMIC_LOAD_RELAXED(&pItem->SizeFlags);
+    KISS_ASSERT(!(SizeFlags & KISS_MPSCQUEUE_READY), "Item has already been committed");
+    /* Publish the payload to the consumer */
+    KISS_ATOMIC_STORE(&pItem->SizeFlags, SizeFlags | KISS_MPSCQUEUE_READY);
+}
+
+/* ===============================================================================
+* Name: KISS_MPSCQUEUE_GetPtr()
+* Description: Get the pointer to first element stored in the queue
+* Parameters:   [I/O] pQ - Pointer to the queue to retrieve data from.
+*               [O] ppData - Pointer to pointer to receive the first element.
+*               [O] pSize - Optional pointer to receive the size of the element.
+* Return: int - Returns 0 on success, non-zero if the queue is empty or the first
+*               element has not been committed yet.
+* Caution/Notes: Must only be called from the consumer thread. The element remains
+*                owned by the consumer until KISS_MPSCQUEUE_Purge() is called.
+================================================================================== */
+int KISS_MPSCQUEUE_GetPtr(KISS_MPSCQUEUE* pQ, void** ppData, KISS_UINT* pSize) {
+    KISS_ASSERT(pQ != NULL, "Queue must be a valid pointer");
+    if (ppData != NULL) {
+        const KISS_UINT oHead = KISS_ATOMIC_LOAD_RELAXED(&pQ->oHead);
+        KISS_MPSCQUEUE_ITEM* pItem = __item(pQ, oHead);
+        KISS_UINT SizeFlags = KISS_ATOMIC_LOAD(&pItem->SizeFlags);
+
+        if ((SizeFlags & (KISS_MPSCQUEUE_READY | KISS_MPSCQUEUE_PAD)) == (KISS_MPSCQUEUE_READY | KISS_MPSCQUEUE_PAD)) {
+            /* Skip the padding at the end of the buffer and release it to the producers */
+            const KISS_UINT oNext = pItem->oNext;
+            KISS_MEMSET(pItem, 0, oNext - oHead);
+            KISS_ATOMIC_STORE(&pQ->oHead, oNext);
+            pItem = __item(pQ, oNext);
+            SizeFlags = KISS_ATOMIC_LOAD(&pItem->SizeFlags);
+        }
+        if (SizeFlags & KISS_MPSCQUEUE_READY) {
+            *ppData = (uint8_t*)pItem + sizeof(KISS_MPSCQUEUE_ITEM);
+            if (pSize != NULL) {
+                *pSize = SizeFlags & KISS_MPSCQUEUE_MAX_ITEM_SIZE;
+            }
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/* ===============================================================================
+* Name: KISS_MPSCQUEUE_Purge()
+* Description: Remove the top most element from the queue, releasing its space to the producers.
+* Parameters: [I/O] pQ - Pointer to the queue to modify
+* Return: None
+* Caution/Notes: Must only be called from the consumer thread after a successful
+*                call to KISS_MPSCQUEUE_GetPtr().
+================================================================================== */
+void KISS_MPSCQUEUE_Purge(KISS_MPSCQUEUE* pQ) {
+    KISS_ASSERT(pQ != NULL, "Queue must be a valid pointer");
+    const KISS_UINT oHead = KISS_ATOMIC_LOAD_RELAXED(&pQ->oHead);
+    KISS_MPSCQUEUE_ITEM* pItem = __item(pQ, oHead);
+    const KISS_UINT SizeFlags = KISS_ATOMIC_LOAD(&pItem->SizeFlags);
+    if ((SizeFlags & (KISS_MPSCQUEUE_READY | KISS_MPSCQUEUE_PAD)) == KISS_MPSCQUEUE_READY) {
+        const KISS_UINT oNext = pItem->oNext;
+        /* Zero the record so its bytes can't be mistaken for a published header later */
+        KISS_MEMSET(pItem, 0, oNext - oHead);
+        KISS_ATOMIC_STORE(&pQ->oHead, oNext);
+    }
+}
+
+/* ===============================================================================
+* Name: KISS_MPSCQUEUE_GetByteCnt()
+* Description: Get the number of bytes reserved in the queue, including headers and padding.
+* Parameters: [I] pQ - Pointer to the queue
+* Return: KISS_UINT - Number of bytes between the head and the tail of the queue
+* Caution/Notes: The result is only a snapshot if other threads are active.
+================================================================================== */
+KISS_UINT KISS_MPSCQUEUE_GetByteCnt(const KISS_MPSCQUEUE* pQ) {
+    KISS_ASSERT(pQ != NULL, "Queue must be a valid pointer");
+    const KISS_UINT oHead = KISS_ATOMIC_LOAD(&pQ->oHead);
+    const KISS_UINT oTail = KISS_ATOMIC_LOAD(&pQ->oTail);
+    return oTail - oHead;
+}
+
+static KISS_MPSCQUEUE_ITEM* __item(const KISS_MPSCQUEUE* pQ, KISS_UINT o) {
+    return (KISS_MPSCQUEUE_ITEM*)&pQ->pBuffer[o & (pQ->TotalSize - 1)];
+}
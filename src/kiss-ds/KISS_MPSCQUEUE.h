@@ -0,0 +1,91 @@
+/*================================================================================
+*   zlib/libpng license
+*
+*   Copyright (c) 2021. Denis Hilliard
+*
+*   This software is provided 'as-is', without any express or implied warranty.
+*    In no event will the authors be held liable for any damages arising from the
+*    use of this software.
+*
+*    Permission is granted to anyone to use this software for any purpose,
+*    including commercial applications, and to alter it and redistribute it
+*    freely, subject to the following restrictions:
+*
+*        1. The origin of this software must not be misrepresented; you must not
+*        claim that you wrote the original software. If you use this software in a
+*        product, an acknowledgment in the product documentation would be
+*        appreciated but is not required.
+*
+*        2. Altered source versions must be plainly marked as such, and must not
+*        be misrepresented as being the original software.
+*
+*        3. This notice may not be removed or altered from any source
+*        distribution.
+*
+*   Component: Multi Producer/Single Consumer Queue
+*   File: KISS_MPSCQUEUE.h
+*   Description:  This file implements the logic for a lock-free queue of variable
+*                 size elements written by many producer threads and read by one
+*                 consumer thread.
+*   Caution/Notes:  None
+*=================================================================================*/
+#ifndef _KISS_MPSCQUEUE_H_
+#define _KISS_MPSCQUEUE_H_
+
+#include "KISS_Common.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Alignment of every record (header + data) in the buffer */
+#define KISS_MPSCQUEUE_ALIGN 8
+/* Largest payload a single record can hold */
+#define KISS_MPSCQUEUE_MAX_ITEM_SIZE 0x3FFFFFFF
+
+/*
+KISS_MPSCQUEUE allows any number of producer threads to push variable size elements to a single
+consumer thread. Producers reserve space by advancing the shared tail offset with a CAS, write
+their record concurrently and then publish it by setting the ready flag in the record header.
+The consumer follows the chain of records from the head and stops at the first record that is not
+published yet, so records are consumed in reservation order.
+A record that does not fit before the end of the buffer is preceded by a padding record and placed
+at the start of the buffer. The consumer zeroes each record it consumes so stale data is never
+mistaken for a published header.
+Offsets run freely and TotalSize must be a power of 2.
+*/
+typedef struct {
+    /* Read-only after creation */
+    uint8_t* pBuffer;
+    KISS_UINT TotalSize;
+    uint8_t Pad0[KISS_CACHELINE_SIZE];
+    /* Shared by the producers */
+    KISS_UINT oTail;
+    uint8_t Pad1[KISS_CACHELINE_SIZE - sizeof(KISS_UINT)];
+    /* Written by the consumer only */
+    KISS_UINT oHead;
+    uint8_t Pad2[KISS_CACHELINE_SIZE - sizeof(KISS_UINT)];
+} KISS_MPSCQUEUE;
+
+/* Size = Size in bytes of the data buffer. Must be a power of 2, pData must be aligned to KISS_MPSCQUEUE_ALIGN */
+void KISS_MPSCQUEUE_Create(KISS_MPSCQUEUE* pQ, void* pData, KISS_UINT Size);
+void KISS_MPSCQUEUE_Delete(KISS_MPSCQUEUE* pQ);
+/* Get the number of bytes reserved in the queue. Only a snapshot when called concurrently. */
+KISS_UINT KISS_MPSCQUEUE_GetByteCnt(const KISS_MPSCQUEUE* pQ);
+
+/* Producer side, thread safe. Returns 0 on success */
+int KISS_MPSCQUEUE_Put(KISS_MPSCQUEUE* pQ, const void* pSrc, KISS_UINT Size);
+/* Reserve space for an item of Size bytes and return a pointer to its payload, or NULL if the queue is full */
+void* KISS_MPSCQUEUE_Alloc(KISS_MPSCQUEUE* pQ, KISS_UINT Size);
+/* Must be used with KISS_MPSCQUEUE_Alloc() to publish the item to the consumer */
+void KISS_MPSCQUEUE_Commit(KISS_MPSCQUEUE* pQ, void* pData);
+
+/* Consumer side. Returns 0 on success */
+int KISS_MPSCQUEUE_GetPtr(KISS_MPSCQUEUE* pQ, void** ppData, KISS_UINT* pSize);
+/* Must be used with KISS_MPSCQUEUE_GetPtr() to release the element to the producers */
+void KISS_MPSCQUEUE_Purge(KISS_MPSCQUEUE* pQ);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -29,16 +29,46 @@
 *=================================================================================*/
 #include "KISS_QUEUE.h"
 
+#if defined(__unix__) || defined(__APPLE__)
+#include <limits.h>
+#include <sys/uio.h>
+#endif
+
 /* TODO: FIX KISS_QUEUE to use a single KISS_UINT16 to indicate the length of the record */
 typedef struct {
     KISS_UINT oNext;
     KISS_UINT oSize;
 } KISS_QUEUE_ITEM;
 
+/* With KISS_QUEUE_FLAG_COMPACT an item starts with its size: 1 byte for sizes below 0x80,
+   otherwise 2 bytes, big endian with the top bit set. Any alignment padding follows the size
+   and the next item starts right after the payload. A 0xFF byte after the tail item marks
+   that the next item wrapped to the start of the buffer */
+#define KISS_QUEUE_COMPACT_WRAP 0xFF
 
 
-/* Internal function shared between KISS_QUEUE_Put and KISS_QUEUE_PutEx to allocate a new queue item within the buffer */
-static void* __alloc_item(KISS_QUEUE* pQ, KISS_UINT Size);
+/* Internal function to reserve a new queue item, evicting the oldest items if allowed. Returns 0 on success */
+static int __reserve_item(KISS_QUEUE* pQ, KISS_UINT Size);
+/* Internal function to reserve a new queue item within the free space of the buffer. Returns 0 on success */
+static int __reserve_space(KISS_QUEUE* pQ, KISS_UINT Size);
+/* Internal function to append the reserved item to the queue */
+static void __commit_item(KISS_QUEUE* pQ, KISS_UINT Size);
+/* Internal function to write the header of the item at offset oItem */
+static void __write_header(KISS_QUEUE* pQ, KISS_UINT oItem, KISS_UINT HdrSize, KISS_UINT Size);
+/* Internal function to make the item at offset oItem follow the item at offset oPrev */
+static void __link_item(KISS_QUEUE* pQ, KISS_UINT oPrev, KISS_UINT oItem);
+/* Internal function to get the size of the header of an item of the given Size */
+static KISS_UINT __header_size(const KISS_QUEUE* pQ, KISS_UINT Size);
+/* Internal function to get the size of the header of the item at offset oItem */
+static KISS_UINT __item_header_size(const KISS_QUEUE* pQ, KISS_UINT oItem);
+/* Internal function to get the offset of the payload of an item written at offset o */
+static KISS_UINT __data_offset(const KISS_QUEUE* pQ, KISS_UINT o, KISS_UINT HdrSize);
+/* Internal function to get the offset and size of the payload of the item at offset oItem */
+static KISS_UINT __item_data(const KISS_QUEUE* pQ, KISS_UINT oItem, KISS_UINT* pSize);
+/* Internal function to get the offset just past the payload of the item at offset oItem */
+static KISS_UINT __item_end(const KISS_QUEUE* pQ, KISS_UINT oItem);
+/* Internal function to get the offset of the item following the item at offset oItem */
+static KISS_UINT __next_item(const KISS_QUEUE* pQ, KISS_UINT oItem);
 
 /* ===============================================================================
 * Name: KISS_QUEUE_Create()
@@ -47,16 +77,48 @@ static void* __alloc_item(KISS_QUEUE* pQ, KISS_UINT Size);
 *               [I] pData - Pointer to buffer to use for queue storage
 *               [I] Size - The size of each element.           
 * Return: None
-* Caution/Notes:    None
+* Caution/Notes:    Items are packed without any alignment.
 ================================================================================== */
 void KISS_QUEUE_Create(KISS_QUEUE* pQ, void* pData, KISS_UINT Size) {
+    KISS_QUEUE_CreateEx(pQ, pData, Size, 1, 0);
+}
+/* ===============================================================================
+* Name: KISS_QUEUE_CreateEx()
+* Description: Initialise the queue with a fixed size / preallocated memory buffer
+*              and an alignment for the payload of each item.
+* Parameters:   [O] pQ - Pointer to the queue to initialise
+*               [I] pData - Pointer to buffer to use for queue storage
+*               [I] Size - Size (in bytes) of the storage buffer.
+*               [I] Alignment - Alignment of the pointer returned by KISS_QUEUE_GetPtr().
+*                               Must be a power of 2, e.g. 8, 16 or 64.
+*               [I] Flags - Combination of KISS_QUEUE_FLAG_* options
+* Return: None
+* Caution/Notes: Padding is inserted next to each item header as required.
+*                KISS_QUEUE_GetPadBytes() reports the overhead.
+*                KISS_QUEUE_FLAG_COMPACT suits queues of small items: a 4 byte item
+*                takes 5 bytes instead of 12.
+*                KISS_QUEUE_FLAG_OVERWRITE keeps the most recent items, e.g. for an
+*                in-memory event log.
+================================================================================== */
+void KISS_QUEUE_CreateEx(KISS_QUEUE* pQ, void* pData, KISS_UINT Size, KISS_UINT16 Alignment, KISS_UINT16 Flags) {
     KISS_ASSERT(pQ != NULL, "Queue must be a valid pointer");
+    KISS_ASSERT(KISS_IS_POW2(Alignment), "The alignment must be a power of 2");
     pQ->pBuffer = pData;
     pQ->TotalSize = Size;
     pQ->oHead = 0;
     pQ->oTail = 0;
+    pQ->oPrevTail = 0;
+    pQ->oReserved = 0;
+    pQ->NumReserved = 0;
+    pQ->NumPadBytes = 0;
+    pQ->NumDropped = 0;
+    pQ->NumDroppedBytes = 0;
+    pQ->ReservedPad = 0;
+    pQ->ReservedHdr = 0;
+    pQ->Alignment = Alignment;
     pQ->NumElements = 0;
     pQ->UseCount = 0;
+    pQ->Flags = Flags;
 }
 /* ===============================================================================
 * Name: KISS_QUEUE_Delete()
@@ -71,8 +133,18 @@ void KISS_QUEUE_Delete(KISS_QUEUE* pQ) {
     pQ->TotalSize = 0;
     pQ->oHead = 0;
     pQ->oTail = 0;
+    pQ->oPrevTail = 0;
+    pQ->oReserved = 0;
+    pQ->NumReserved = 0;
+    pQ->NumPadBytes = 0;
+    pQ->NumDropped = 0;
+    pQ->NumDroppedBytes = 0;
+    pQ->ReservedPad = 0;
+    pQ->ReservedHdr = 0;
+    pQ->Alignment = 0;
     pQ->NumElements = 0;
     pQ->UseCount = 0;
+    pQ->Flags = 0;
 }
 /* ===============================================================================
 * Name: KISS_QUEUE_Clear()
@@ -85,6 +157,7 @@ void KISS_QUEUE_Clear(KISS_QUEUE* pQ) {
     KISS_ASSERT(pQ != NULL, "Queue must be a valid pointer");
     pQ->oHead = 0;
     pQ->oTail = 0;
+    pQ->NumReserved = 0;
     pQ->NumElements = 0;
 }
 /* ===============================================================================
@@ -99,11 +172,11 @@ void KISS_QUEUE_Clear(KISS_QUEUE* pQ) {
 int KISS_QUEUE_Put(KISS_QUEUE* pQ, const void* pSrc, KISS_UINT Size) {
     KISS_ASSERT(pQ != NULL, "Queue must be a valid pointer");
     /* Attempt to add an item to the queue */
-    void* pDest = __alloc_item(pQ, Size);
+    void* pDest = KISS_QUEUE_Alloc(pQ, Size);
     if (pDest != NULL) {
         /* Copy the data from the source area into the new memory location */
         KISS_MEMCPY(pDest, pSrc, Size);
-        return 0;
+        return KISS_QUEUE_Commit(pQ, Size);
     }
     return 1;
 }
@@ -127,7 +200,7 @@ int KISS_QUEUE_PutEx(KISS_QUEUE* pQ, const KISS_QUEUE_SRCLIST* pSrcList, KISS_UI
             Size += pSrcList[i].Size;
         }
         /* Attempt to add an item to the queue */
-        uint8_t* pDest = (uint8_t*)__alloc_item(pQ, Size);
+        uint8_t* pDest = (uint8_t*)KISS_QUEUE_Alloc(pQ, Size);
 
         if (pDest != NULL) {
             /* Copy data from each chunk into the destination memory chunk */
@@ -135,13 +208,126 @@ int KISS_QUEUE_PutEx(KISS_QUEUE* pQ, const KISS_QUEUE_SRCLIST* pSrcList, KISS_UI
                 KISS_MEMCPY(pDest, pSrcList[i].pSrc, pSrcList[i].Size);
                 pDest += pSrcList[i].Size;
             }
-            return 0;
+            return KISS_QUEUE_Commit(pQ, Size);
         }
     }
 
     return 1;
 }
 /* ===============================================================================
+* Name: KISS_QUEUE_Alloc()
+* Description:  Reserve space for an item at the end of the queue so it can be
+*               built in place.
+* Parameters:   [I/O] pQ - Pointer to the queue to modify
+*               [I] Size - Maximum size of the item.
+* Return: void* - Pointer to the payload of the reserved item, or NULL if the
+*                 queue has no room for it (or, with KISS_QUEUE_FLAG_COMPACT, Size
+*                 exceeds KISS_QUEUE_COMPACT_MAX_SIZE).
+* Caution/Notes: The item is not part of the queue until KISS_QUEUE_Commit() is
+*                called. Only one item can be reserved at a time; calling this
+*                function again or KISS_QUEUE_Clear() discards the reservation.
+*                With KISS_QUEUE_FLAG_OVERWRITE the oldest items are evicted until
+*                the item fits, unless the front is locked by KISS_QUEUE_GetPtr().
+================================================================================== */
+void* KISS_QUEUE_Alloc(KISS_QUEUE* pQ, KISS_UINT Size) {
+    KISS_ASSERT(pQ != NULL, "Queue must be a valid pointer");
+    if (__reserve_item(pQ, Size) == 0) {
+        return &pQ->pBuffer[pQ->oReserved + pQ->ReservedHdr];
+    }
+    return NULL;
+}
+/* ===============================================================================
+* Name: KISS_QUEUE_Commit()
+* Description:  Add the item reserved by KISS_QUEUE_Alloc() to the end of the queue.
+* Parameters:   [I/O] pQ - Pointer to the queue to modify
+*               [I] Size - Final size of the item. May be smaller than the size
+*                          passed to KISS_QUEUE_Alloc(), the rest is released.
+* Return: int - Returns 0 on success, non-zero if there is no reservation or Size
+*               exceeds it.
+* Caution/Notes:    None
+================================================================================== */
+int KISS_QUEUE_Commit(KISS_QUEUE* pQ, KISS_UINT Size) {
+    KISS_ASSERT(pQ != NULL, "Queue must be a valid pointer");
+    if (pQ->NumReserved > 0 && Size <= pQ->NumReserved - pQ->ReservedHdr) {
+        __commit_item(pQ, Size);
+        return 0;
+    }
+    return 1;
+}
+/* ===============================================================================
+* Name: KISS_QUEUE_Append()
+* Description:  Append data to the payload of the item at the end of the queue.
+* Parameters:   [I/O] pQ - Pointer to the queue to modify
+*               [I] pSrc - Pointer to the data to append
+*               [I] Size - Size of the data to append
+* Return: int - Returns 0 on success, non-zero if the queue is empty, its front is
+*               locked or there is no room for the larger item.
+* Caution/Notes: If the item can't grow in place because it would cross the end of
+*                the buffer it is moved to the start of the buffer, so pointers to
+*                its payload are only valid until the next call. A compact header
+*                growing to 2 bytes also moves the payload up within the item.
+*                Discards a reservation made by KISS_QUEUE_Alloc(). Never evicts
+*                items, even with KISS_QUEUE_FLAG_OVERWRITE.
+================================================================================== */
+int KISS_QUEUE_Append(KISS_QUEUE* pQ, const void* pSrc, KISS_UINT Size) {
+    KISS_ASSERT(pQ != NULL, "Queue must be a valid pointer");
+    pQ->NumReserved = 0;
+    if (pQ->NumElements == 0 || pQ->UseCount > 0) {
+        return 1;
+    }
+    KISS_UINT OldSize = 0;
+    const KISS_UINT HdrSize = __item_header_size(pQ, pQ->oTail);
+    const KISS_UINT oData = __item_data(pQ, pQ->oTail, &OldSize);
+    const KISS_UINT NewSize = OldSize + Size;
+    /* The tail item either ends the used region or has wrapped and must stay in front of the head */
+    const KISS_UINT Limit = (pQ->oTail >= pQ->oHead) ? pQ->TotalSize : pQ->oHead;
+
+    if (NewSize < OldSize || ((pQ->Flags & KISS_QUEUE_FLAG_COMPACT) && NewSize > KISS_QUEUE_COMPACT_MAX_SIZE)) {
+        return 1;
+    }
+    if (__header_size(pQ, NewSize) <= HdrSize && Size <= Limit - (oData + OldSize)) {
+        /* Grow in place, keeping the header size */
+        KISS_MEMCPY(&pQ->pBuffer[oData + OldSize], pSrc, Size);
+        __write_header(pQ, pQ->oTail, HdrSize, NewSize);
+        return 0;
+    }
+    if (__header_size(pQ, NewSize) > HdrSize) {
+        /* The compact header grows to 2 bytes: shift the payload up behind it if there is room */
+        const KISS_UINT oNewData = __data_offset(pQ, pQ->oTail, 2);
+        if (oNewData <= Limit && NewSize <= Limit - oNewData) {
+            KISS_MEMMOVE(&pQ->pBuffer[oNewData], &pQ->pBuffer[oData], OldSize);
+            KISS_MEMCPY(&pQ->pBuffer[oNewData + OldSize], pSrc, Size);
+            __write_header(pQ, pQ->oTail, 2, NewSize);
+            if (oNewData > oData) {
+                pQ->NumPadBytes += oNewData - oData - 1;
+            }
+            return 0;
+        }
+    }
+    if (pQ->oTail >= pQ->oHead) {
+        /* Move the item to the start of the buffer, in front of the head unless it is the only item */
+        const KISS_UINT NewHdrSize = __header_size(pQ, NewSize);
+        const KISS_UINT oNewData = __data_offset(pQ, 0, NewHdrSize);
+        const KISS_UINT NewLimit = (pQ->NumElements > 1) ? pQ->oHead : pQ->TotalSize;
+        if (oNewData <= NewLimit && NewSize <= NewLimit - oNewData) {
+            const KISS_UINT oItem = (pQ->Flags & KISS_QUEUE_FLAG_COMPACT) ? 0 : oNewData - NewHdrSize;
+            KISS_MEMMOVE(&pQ->pBuffer[oNewData], &pQ->pBuffer[oData], OldSize);
+            KISS_MEMCPY(&pQ->pBuffer[oNewData + OldSize], pSrc, Size);
+            __write_header(pQ, oItem, NewHdrSize, NewSize);
+            if (pQ->NumElements > 1) {
+                __link_item(pQ, pQ->oPrevTail, oItem);
+            }
+            else {
+                pQ->oHead = oItem;
+            }
+            pQ->oTail = oItem;
+            pQ->NumPadBytes += oNewData - NewHdrSize;
+            return 0;
+        }
+    }
+    return 1;
+}
+/* ===============================================================================
 * Name: KISS_QUEUE_GetPtr()
 * Description: Get the pointer to first element stored in the queue
 * Parameters:   [I/O] pQ - Pointer to the queue to retrieve data from.
@@ -155,7 +341,7 @@ int KISS_QUEUE_GetPtr(KISS_QUEUE* pQ, void** ppData) {
     if (pQ->NumElements > 0) {
         pQ->UseCount++;
         KISS_ASSERT(pQ->UseCount != 0, "Queue should be in use");
-        *ppData = &pQ->pBuffer[(pQ->oHead + sizeof(KISS_QUEUE_ITEM))];
+        *ppData = &pQ->pBuffer[__item_data(pQ, pQ->oHead, NULL)];
         return 0;
     }
     return 1;
@@ -176,11 +362,132 @@ void KISS_QUEUE_Purge(KISS_QUEUE* pQ) {
             KISS_ASSERT(pQ->UseCount == 0, "Queue is currently in use");
         }
         /* Retrieve the next element offset from the current head & update the queue */
-        KISS_QUEUE_ITEM* pHead = (KISS_QUEUE_ITEM*)&pQ->pBuffer[pQ->oHead];
-        pQ->oHead = pHead->oNext;
+        pQ->oHead = __next_item(pQ, pQ->oHead);
         pQ->NumElements--;
+        if (pQ->NumElements == 0 && pQ->NumReserved == 0) {
+            /* Restart at the beginning of the buffer to keep the free space contiguous */
+            pQ->oHead = 0;
+            pQ->oTail = 0;
+        }
+    }
+}
+/* ===============================================================================
+* Name: KISS_QUEUE_GetPtrN()
+* Description: Get the location and size of several items at the front of the queue
+* Parameters:   [I/O] pQ - Pointer to the queue to retrieve data from.
+*               [O] pSpans - Array to receive the items, front first.
+*               [I] MaxCount - Maximum number of items to retrieve.
+* Return: KISS_UINT - Number of spans filled in. 0 if the queue is empty.
+* Caution/Notes: Like KISS_QUEUE_GetPtr() this locks the front of the queue.
+*                KISS_QUEUE_PurgeN() releases the items.
+================================================================================== */
+KISS_UINT KISS_QUEUE_GetPtrN(KISS_QUEUE* pQ, KISS_QUEUE_SPAN* pSpans, KISS_UINT MaxCount) {
+    KISS_ASSERT(pQ != NULL, "Queue must be a valid pointer");
+    const KISS_UINT Num = KISS_MIN(MaxCount, pQ->NumElements);
+    if (Num > 0 && pSpans != NULL) {
+        KISS_UINT oItem = pQ->oHead;
+        pQ->UseCount++;
+        KISS_ASSERT(pQ->UseCount != 0, "Queue should be in use");
+        /* Follow the chain of items from the head */
+        for (KISS_UINT i = 0; i < Num; ++i) {
+            pSpans[i].pData = &pQ->pBuffer[__item_data(pQ, oItem, &pSpans[i].Size)];
+            oItem = __next_item(pQ, oItem);
+        }
+        return Num;
+    }
+    return 0;
+}
+/* ===============================================================================
+* Name: KISS_QUEUE_PurgeN()
+* Description: Remove up to Count items from the front of the queue.
+* Parameters: [I/O] pQ - Pointer to the queue to modify
+*             [I] Count - Number of items to remove.
+* Return: None
+* Caution/Notes: The items should have been retrieved first by KISS_QUEUE_GetPtrN().
+*                The head of the queue is updated once for the whole batch.
+================================================================================== */
+void KISS_QUEUE_PurgeN(KISS_QUEUE* pQ, KISS_UINT Count) {
+    KISS_ASSERT(pQ != NULL, "Queue must be a valid pointer");
+    const KISS_UINT Num = KISS_MIN(Count, pQ->NumElements);
+
+    if (pQ->UseCount > 0) {
+        pQ->UseCount--;
+        KISS_ASSERT(pQ->UseCount == 0, "Queue is currently in use");
+    }
+    if (Num > 0) {
+        KISS_UINT oHead = pQ->oHead;
+        for (KISS_UINT i = 0; i < Num; ++i) {
+            oHead = __next_item(pQ, oHead);
+        }
+        pQ->oHead = oHead;
+        pQ->NumElements -= Num;
+        if (pQ->NumElements == 0 && pQ->NumReserved == 0) {
+            /* Restart at the beginning of the buffer to keep the free space contiguous */
+            pQ->oHead = 0;
+            pQ->oTail = 0;
+        }
+    }
+}
+#if defined(__unix__) || defined(__APPLE__)
+/* ===============================================================================
+* Name: KISS_QUEUE_WriteFd()
+* Description: Write the items at the front of the queue straight from the queue
+*              buffer to a file descriptor and remove the items written.
+* Parameters: [I/O] pQ - Pointer to the queue to modify
+*             [I] fd - File descriptor to write to
+*             [I/O] pOffset - Number of bytes of the front item already written.
+*                             Must be 0 for the first call, updated on return.
+* Return: int - Number of bytes written, 0 if the queue is empty, -1 on error with
+*               errno set by writev().
+* Caution/Notes: Up to KISS_QUEUE_MAX_IOV items are gathered into one writev() call,
+*                which may be partial. An item written partially stays at the front
+*                of the queue and *pOffset records how much of it was written.
+*                Must not be called while the front is locked by KISS_QUEUE_GetPtr().
+================================================================================== */
+int KISS_QUEUE_WriteFd(KISS_QUEUE* pQ, int fd, KISS_UINT* pOffset) {
+    KISS_ASSERT(pQ != NULL, "Queue must be a valid pointer");
+    KISS_ASSERT(pOffset != NULL, "Offset must be a valid pointer");
+    KISS_ASSERT(pQ->UseCount == 0, "Queue is currently in use");
+#if defined(IOV_MAX) && IOV_MAX < KISS_QUEUE_MAX_IOV
+    struct iovec iov[IOV_MAX];
+#else
+    struct iovec iov[KISS_QUEUE_MAX_IOV];
+#endif
+    const KISS_UINT Num = KISS_MIN(pQ->NumElements, (KISS_UINT)(sizeof(iov) / sizeof(iov[0])));
+
+    if (Num > 0) {
+        KISS_UINT oItem = pQ->oHead;
+        /* Follow the chain of items from the head */
+        for (KISS_UINT i = 0; i < Num; ++i) {
+            KISS_UINT Size = 0;
+            iov[i].iov_base = &pQ->pBuffer[__item_data(pQ, oItem, &Size)];
+            iov[i].iov_len = Size;
+            oItem = __next_item(pQ, oItem);
+        }
+        KISS_ASSERT(*pOffset <= iov[0].iov_len, "Offset exceeds the size of the front item");
+        iov[0].iov_base = (uint8_t*)iov[0].iov_base + *pOffset;
+        iov[0].iov_len -= *pOffset;
+
+        const ssize_t Written = writev(fd, iov, (int)Num);
+        if (Written >= 0) {
+            /* Count the items written completely, the rest of the bytes belong to the next item */
+            size_t Left = (size_t)Written;
+            KISS_UINT NumDone = 0;
+            while (NumDone < Num && iov[NumDone].iov_len <= Left) {
+                Left -= iov[NumDone].iov_len;
+                NumDone++;
+            }
+            if (NumDone > 0) {
+                KISS_QUEUE_PurgeN(pQ, NumDone);
+                *pOffset = 0;
+            }
+            *pOffset += (KISS_UINT)Left;
+        }
+        return (int)Written;
     }
+    return 0;
 }
+#endif
 /* ===============================================================================
 * Name: KISS_QUEUE_GetItemCnt()
 * Description: Get the number of elements currently in the queue.
@@ -214,12 +521,46 @@ KISS_BOOL KISS_QUEUE_IsInUse(const KISS_QUEUE* pQ) {
 int KISS_QUEUE_GetItemSize(const KISS_QUEUE* pQ) {
     KISS_ASSERT(pQ != NULL, "Queue must be a valid pointer");
     if (pQ->NumElements > 0) {
-        const KISS_QUEUE_ITEM* pHead = (KISS_QUEUE_ITEM*)&pQ->pBuffer[pQ->oHead];
-        return pHead->oSize;
+        KISS_UINT Size = 0;
+        __item_data(pQ, pQ->oHead, &Size);
+        return (int)Size;
     }
     return 0;
 }
 /* ===============================================================================
+* Name: KISS_QUEUE_GetPadBytes()
+* Description: Gets the number of bytes spent on aligning item payloads.
+* Parameters: [I] pQ - Pointer to the queue.
+* Return: KISS_UINT - Total alignment padding of all items added since the queue was created.
+* Caution/Notes: Always 0 for a queue created with an alignment of 1.
+================================================================================== */
+KISS_UINT KISS_QUEUE_GetPadBytes(const KISS_QUEUE* pQ) {
+    KISS_ASSERT(pQ != NULL, "Queue must be a valid pointer");
+    return pQ->NumPadBytes;
+}
+/* ===============================================================================
+* Name: KISS_QUEUE_GetDropCnt()
+* Description: Get the number of items evicted by a KISS_QUEUE_FLAG_OVERWRITE queue.
+* Parameters: [I] pQ - Pointer to the queue.
+* Return: KISS_UINT - Number of items evicted since the queue was created
+* Caution/Notes: Consumers can compare successive values to detect gaps.
+================================================================================== */
+KISS_UINT KISS_QUEUE_GetDropCnt(const KISS_QUEUE* pQ) {
+    KISS_ASSERT(pQ != NULL, "Queue must be a valid pointer");
+    return pQ->NumDropped;
+}
+/* ===============================================================================
+* Name: KISS_QUEUE_GetDropBytes()
+* Description: Get the payload bytes evicted by a KISS_QUEUE_FLAG_OVERWRITE queue.
+* Parameters: [I] pQ - Pointer to the queue.
+* Return: KISS_UINT - Total size of the items evicted since the queue was created
+* Caution/Notes: Wraps around after 4GB.
+================================================================================== */
+KISS_UINT KISS_QUEUE_GetDropBytes(const KISS_QUEUE* pQ) {
+    KISS_ASSERT(pQ != NULL, "Queue must be a valid pointer");
+    return pQ->NumDroppedBytes;
+}
+/* ===============================================================================
 * Name: KISS_QUEUE_PeekPtr()
 * Description:  Gets the pointer to the top-most item of the queue but does not modify
 *               the underlying queue.
@@ -231,46 +572,174 @@ int KISS_QUEUE_GetItemSize(const KISS_QUEUE* pQ) {
 int KISS_QUEUE_PeekPtr(const KISS_QUEUE* pQ, void** ppData) {
     KISS_ASSERT(pQ != NULL, "Queue must be a valid pointer");
     if (pQ->NumElements > 0) {
-        *ppData = &pQ->pBuffer[(pQ->oHead + sizeof(KISS_QUEUE_ITEM))];
+        *ppData = &pQ->pBuffer[__item_data(pQ, pQ->oHead, NULL)];
         return 0;
     }
     return 1;
 }
 
-/* ===============================================================================
-* Name: __alloc_item()
-* Description:  Internal function shared between KISS_QUEUE_Put and KISS_QUEUE_PutEx 
-                to allocate a new queue item within the buffer
-* Parameters:   [O] pQ - Pointer to queue to modify
-*               [I] Size - Size of item to add to the queue
-* Return: void* - Pointer to the newly allocated item in the queue.
-* Caution/Notes:  
-================================================================================== */
-static void* __alloc_item(KISS_QUEUE* pQ, KISS_UINT Size) {
-    KISS_QUEUE_ITEM* pLast = (KISS_QUEUE_ITEM*)&pQ->pBuffer[pQ->oTail];
-    KISS_UINT oNext = pLast->oNext;
-    const KISS_UINT oNextNext = (oNext + sizeof(KISS_QUEUE_ITEM) + Size);
+static int __reserve_item(KISS_QUEUE* pQ, KISS_UINT Size) {
+    int Result = __reserve_space(pQ, Size);
+    if (Result != 0 && (pQ->Flags & KISS_QUEUE_FLAG_OVERWRITE) && pQ->UseCount == 0) {
+        /* Only evict if the item fits into the empty buffer */
+        const KISS_UINT oData = __data_offset(pQ, 0, __header_size(pQ, Size));
+        const KISS_BOOL IsTooLarge = (pQ->Flags & KISS_QUEUE_FLAG_COMPACT) && Size > KISS_QUEUE_COMPACT_MAX_SIZE;
+        if (!IsTooLarge && oData <= pQ->TotalSize && Size <= pQ->TotalSize - oData) {
+            /* Each item is evicted at most once, so this is O(1) amortized */
+            while (Result != 0 && pQ->NumElements > 0) {
+                KISS_UINT DropSize = 0;
+                __item_data(pQ, pQ->oHead, &DropSize);
+                pQ->NumDropped++;
+                pQ->NumDroppedBytes += DropSize;
+                KISS_QUEUE_Purge(pQ);
+                Result = __reserve_space(pQ, Size);
+            }
+        }
+    }
+    return Result;
+}
+
+static int __reserve_space(KISS_QUEUE* pQ, KISS_UINT Size) {
+    const KISS_UINT HdrSize = __header_size(pQ, Size);
+    KISS_UINT oWrite = 0;
+    KISS_UINT oData = 0;
+    pQ->NumReserved = 0;
 
-    if ((oNextNext <= pQ->TotalSize) || (oNextNext <= pQ->oHead)) {
-        /* End of buffer hasn't been reached or oNext has already been wrapped around: nothing to do. */
+    if (Size > pQ->TotalSize || ((pQ->Flags & KISS_QUEUE_FLAG_COMPACT) && Size > KISS_QUEUE_COMPACT_MAX_SIZE)) {
+        return 1;
     }
-    else if ((0 + sizeof(KISS_QUEUE_ITEM) + Size) < pQ->oHead) {
-        /* Wrap oNext around to the beginning of the buffer */
-        oNext = 0;
-        pLast->oNext = oNext;
+    if (pQ->NumElements == 0) {
+        /* Empty queue: the whole buffer is available */
+        pQ->oHead = 0;
+        pQ->oTail = 0;
+        oData = __data_offset(pQ, 0, HdrSize);
+        if (oData > pQ->TotalSize || Size > pQ->TotalSize - oData) {
+            return 1;
+        }
     }
     else {
-        /* Unable to fit the item in the queue */
-        return NULL;
+        /* The item after the tail is written where the tail item ends */
+        oWrite = __item_end(pQ, pQ->oTail);
+        oData = __data_offset(pQ, oWrite, HdrSize);
+        if (oWrite > pQ->oHead) {
+            /* Items occupy [oHead, oWrite): use the end of the buffer, else wrap to the start */
+            if (oData > pQ->TotalSize || Size > pQ->TotalSize - oData) {
+                oWrite = 0;
+                oData = __data_offset(pQ, 0, HdrSize);
+                if (oData > pQ->oHead || Size > pQ->oHead - oData) {
+                    return 1;
+                }
+            }
+        }
+        else if (oData > pQ->oHead || Size > pQ->oHead - oData) {
+            /* Items have wrapped and occupy [oHead, end) and [0, oWrite) */
+            return 1;
+        }
     }
-    KISS_QUEUE_ITEM* pNext = (KISS_QUEUE_ITEM*)&pQ->pBuffer[oNext];
-    void* pDest = ((uint8_t*)pNext) + sizeof(KISS_QUEUE_ITEM);
-    pNext->oNext = oNext + sizeof(KISS_QUEUE_ITEM) + Size;
-    pNext->oSize = Size;
+    /* The compact header is written first, the full header right in front of the payload */
+    pQ->oReserved = (pQ->Flags & KISS_QUEUE_FLAG_COMPACT) ? oWrite : oData - HdrSize;
+    pQ->ReservedHdr = (KISS_UINT16)(oData - pQ->oReserved);
+    pQ->ReservedPad = (KISS_UINT16)(oData - oWrite - HdrSize);
+    pQ->NumReserved = pQ->ReservedHdr + Size;
+    return 0;
+}
 
+static void __commit_item(KISS_QUEUE* pQ, KISS_UINT Size) {
+    /* Keep the header size chosen at reservation as the payload is already in place */
+    __write_header(pQ, pQ->oReserved, __header_size(pQ, pQ->NumReserved - pQ->ReservedHdr), Size);
+    if (pQ->NumElements > 0) {
+        __link_item(pQ, pQ->oTail, pQ->oReserved);
+        pQ->oPrevTail = pQ->oTail;
+    }
+    else {
+        pQ->oHead = pQ->oReserved;
+    }
     /* Update variables in the queue object */
-    pQ->oTail = oNext;
+    pQ->oTail = pQ->oReserved;
+    pQ->NumPadBytes += pQ->ReservedPad;
+    pQ->NumReserved = 0;
     pQ->NumElements++;
+}
+
+static void __write_header(KISS_QUEUE* pQ, KISS_UINT oItem, KISS_UINT HdrSize, KISS_UINT Size) {
+    if (pQ->Flags & KISS_QUEUE_FLAG_COMPACT) {
+        uint8_t* pHdr = &pQ->pBuffer[oItem];
+        if (HdrSize == 1) {
+            pHdr[0] = (uint8_t)Size;
+        }
+        else {
+            pHdr[0] = (uint8_t)(0x80 | (Size >> 8));
+            pHdr[1] = (uint8_t)Size;
+        }
+    }
+    else {
+        KISS_QUEUE_ITEM* pItem = (KISS_QUEUE_ITEM*)&pQ->pBuffer[oItem];
+        pItem->oNext = __data_offset(pQ, oItem, HdrSize) + Size;
+        pItem->oSize = Size;
+    }
+}
+
+static void __link_item(KISS_QUEUE* pQ, KISS_UINT oPrev, KISS_UINT oItem) {
+    if (pQ->Flags & KISS_QUEUE_FLAG_COMPACT) {
+        /* Mark the wrap unless the previous item ends exactly at the end of the buffer */
+        const KISS_UINT oEnd = __item_end(pQ, oPrev);
+        if (oItem != oEnd && oEnd < pQ->TotalSize) {
+            pQ->pBuffer[oEnd] = KISS_QUEUE_COMPACT_WRAP;
+        }
+    }
+    else {
+        /* The new item may have wrapped to the start */
+        ((KISS_QUEUE_ITEM*)&pQ->pBuffer[oPrev])->oNext = oItem;
+    }
+}
 
-    return pDest;
+static KISS_UINT __header_size(const KISS_QUEUE* pQ, KISS_UINT Size) {
+    if (pQ->Flags & KISS_QUEUE_FLAG_COMPACT) {
+        return (Size < 0x80) ? 1 : 2;
+    }
+    return sizeof(KISS_QUEUE_ITEM);
+}
+
+static KISS_UINT __data_offset(const KISS_QUEUE* pQ, KISS_UINT o, KISS_UINT HdrSize) {
+    /* Pad so the payload that follows the header is aligned */
+    const uintptr_t Payload = (uintptr_t)&pQ->pBuffer[o] + HdrSize;
+    return o + HdrSize + (KISS_UINT)(KISS_ALIGN_UP(Payload, (uintptr_t)pQ->Alignment) - Payload);
+}
+
+static KISS_UINT __item_header_size(const KISS_QUEUE* pQ, KISS_UINT oItem) {
+    if (pQ->Flags & KISS_QUEUE_FLAG_COMPACT) {
+        return (pQ->pBuffer[oItem] < 0x80) ? 1 : 2;
+    }
+    return sizeof(KISS_QUEUE_ITEM);
+}
+
+static KISS_UINT __item_data(const KISS_QUEUE* pQ, KISS_UINT oItem, KISS_UINT* pSize) {
+    const KISS_UINT HdrSize = __item_header_size(pQ, oItem);
+    if (pSize != NULL) {
+        if (pQ->Flags & KISS_QUEUE_FLAG_COMPACT) {
+            const uint8_t* pHdr = &pQ->pBuffer[oItem];
+            *pSize = (HdrSize == 1) ? pHdr[0] : ((KISS_UINT)(pHdr[0] & 0x7F) << 8) | pHdr[1];
+        }
+        else {
+            *pSize = ((const KISS_QUEUE_ITEM*)&pQ->pBuffer[oItem])->oSize;
+        }
+    }
+    return __data_offset(pQ, oItem, HdrSize);
+}
+
+static KISS_UINT __item_end(const KISS_QUEUE* pQ, KISS_UINT oItem) {
+    KISS_UINT Size = 0;
+    const KISS_UINT oData = __item_data(pQ, oItem, &Size);
+    return oData + Size;
+}
+
+static KISS_UINT __next_item(const KISS_QUEUE* pQ, KISS_UINT oItem) {
+    if (pQ->Flags & KISS_QUEUE_FLAG_COMPACT) {
+        const KISS_UINT oNext = __item_end(pQ, oItem);
+        if (oNext >= pQ->TotalSize || pQ->pBuffer[oNext] == KISS_QUEUE_COMPACT_WRAP) {
+            return 0;
+        }
+        return oNext;
+    }
+    return ((const KISS_QUEUE_ITEM*)&pQ->pBuffer[oItem])->oNext;
 }
@@ -44,7 +44,17 @@ typedef struct KISS_QUEUE {
     KISS_UINT NumElements;
     KISS_UINT oHead;
     KISS_UINT oTail;
+    KISS_UINT oPrevTail; /* Offset of the item in front of the tail item, if any */
+    KISS_UINT oReserved; /* Offset of the item reserved by KISS_QUEUE_Alloc() */
+    KISS_UINT NumReserved; /* Size (in bytes) of the reserved item including its header. 0 if none */
+    KISS_UINT NumPadBytes; /* Bytes spent on aligning items since creation */
+    KISS_UINT NumDropped; /* Items evicted by KISS_QUEUE_FLAG_OVERWRITE since creation */
+    KISS_UINT NumDroppedBytes; /* Payload bytes of the evicted items */
+    KISS_UINT16 ReservedPad; /* Alignment padding of the reserved item */
+    KISS_UINT16 ReservedHdr; /* Offset of the reserved item's payload from its header */
+    KISS_UINT16 Alignment; /* Alignment of each item's payload */
     KISS_UINT16 UseCount;
+    KISS_UINT16 Flags;
 
 } KISS_QUEUE;
 
@@ -53,22 +63,65 @@ typedef struct KISS_QUEUE_SRC_LIST {
     KISS_UINT Size;
 } KISS_QUEUE_SRCLIST;
 
+/* Location and size of an item returned by KISS_QUEUE_GetPtrN() */
+typedef struct KISS_QUEUE_SPAN {
+    void* pData;
+    KISS_UINT Size;
+} KISS_QUEUE_SPAN;
+
+/* Flags for KISS_QUEUE_CreateEx() */
+/* Store the size of each item in a 1 or 2 byte header instead of the 8 byte KISS_QUEUE_ITEM.
+   The next item is located from the size, items are limited to KISS_QUEUE_COMPACT_MAX_SIZE bytes */
+#define KISS_QUEUE_FLAG_COMPACT 0x0001
+#define KISS_QUEUE_COMPACT_MAX_SIZE 0x7EFF
+/* Put/Alloc on a full queue evict the oldest items until the new item fits instead of failing */
+#define KISS_QUEUE_FLAG_OVERWRITE 0x0002
+
 /* Size = Size in bytes of the data buffer */
 void KISS_QUEUE_Create(KISS_QUEUE* pQ, void* pData, KISS_UINT Size);
+/* Create a queue where the payload of every item is aligned to Alignment bytes (a power of 2),
+   with the specified KISS_QUEUE_FLAG_* options */
+void KISS_QUEUE_CreateEx(KISS_QUEUE* pQ, void* pData, KISS_UINT Size, KISS_UINT16 Alignment, KISS_UINT16 Flags);
 void KISS_QUEUE_Delete(KISS_QUEUE* pQ);
 void KISS_QUEUE_Clear(KISS_QUEUE* pQ);
 
 int KISS_QUEUE_Put(KISS_QUEUE* pQ, const void* pSrc, KISS_UINT Size);
 int KISS_QUEUE_PutEx(KISS_QUEUE* pQ, const KISS_QUEUE_SRCLIST* pSrc, KISS_UINT NumSrc);
+/* Reserve space for an item of up to Size bytes at the end of the queue and return a pointer to its payload */
+void* KISS_QUEUE_Alloc(KISS_QUEUE* pQ, KISS_UINT Size);
+/* Must be used with KISS_QUEUE_Alloc() to add the reserved item, shrunk to Size bytes, to the queue */
+int KISS_QUEUE_Commit(KISS_QUEUE* pQ, KISS_UINT Size);
+/* Grow the item at the end of the queue by appending Size bytes to its payload. Returns 0 on success */
+int KISS_QUEUE_Append(KISS_QUEUE* pQ, const void* pSrc, KISS_UINT Size);
 
 int KISS_QUEUE_PeekPtr(const KISS_QUEUE* pQ, void** ppData);
 int KISS_QUEUE_GetPtr(KISS_QUEUE* pQ, void** ppData);
 void KISS_QUEUE_Purge(KISS_QUEUE* pQ);
+/* Get up to MaxCount items from the front of the queue. Returns the number of spans filled in */
+KISS_UINT KISS_QUEUE_GetPtrN(KISS_QUEUE* pQ, KISS_QUEUE_SPAN* pSpans, KISS_UINT MaxCount);
+/* Must be used with KISS_QUEUE_GetPtrN() to remove the first Count items from the queue */
+void KISS_QUEUE_PurgeN(KISS_QUEUE* pQ, KISS_UINT Count);
+
+#if defined(__unix__) || defined(__APPLE__)
+/* Maximum number of items written by one KISS_QUEUE_WriteFd() call (also limited by IOV_MAX) */
+#ifndef KISS_QUEUE_MAX_IOV
+#define KISS_QUEUE_MAX_IOV 64
+#endif
+/* Write the items at the front of the queue to a file descriptor with a single writev() and remove
+   the items written completely. *pOffset holds the number of bytes of the front item written by
+   a previous call. Returns the number of bytes written or -1 on error (see errno) */
+int KISS_QUEUE_WriteFd(KISS_QUEUE* pQ, int fd, KISS_UINT* pOffset);
+#endif
 
 KISS_BOOL KISS_QUEUE_IsInUse(const KISS_QUEUE* pQ);
 
 int KISS_QUEUE_GetItemCnt(const KISS_QUEUE* pQ);
 int KISS_QUEUE_GetItemSize(const KISS_QUEUE* pQ);
+/* Get the number of bytes spent on payload alignment padding since the queue was created */
+KISS_UINT KISS_QUEUE_GetPadBytes(const KISS_QUEUE* pQ);
+/* Get the number of items, and their payload bytes, evicted since creation (KISS_QUEUE_FLAG_OVERWRITE only) */
+KISS_UINT KISS_QUEUE_GetDropCnt(const KISS_QUEUE* pQ);
+KISS_UINT KISS_QUEUE_GetDropBytes(const KISS_QUEUE* pQ);
 
 #ifdef __cplusplus
 }
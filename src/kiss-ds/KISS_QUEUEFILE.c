@@ -0,0 +1,296 @@
+/*================================================================================
+*   zlib/libpng license
+*
+*   Copyright (c) 2021. Denis Hilliard
+*
+*   This software is provided 'as-is', without any express or implied warranty.
+*    In no event will the authors be held liable for any damages arising from the
+*    use of this software.
+*
+*    Permission is granted to anyone to use this software for any purpose,
+*    including commercial applications, and to alter it and redistribute it
+*    freely, subject to the following restrictions:
+*
+*        1. The origin of this software must not be misrepresented; you must not
+*        claim that you wrote the original software. If you use this software in a
+*        product, an acknowledgment in the product documentation would be
+*        appreciated but is not required.
+*
+*        2. Altered source versions must be plainly marked as such, and must not
+*        be misrepresented as being the original software.
+*
+*        3. This notice may not be removed or altered from any source
+*        distribution.
+*
+*   Component: File Backed Queue
+*   File: KISS_QUEUEFILE.c
+*   Description:  This file implements a KISS_QUEUE whose state and storage live
+*                 in a memory mapped file so pending items survive a restart.
+*   Caution/Notes:  Requires POSIX mmap().
+*=================================================================================*/
+#include "KISS_QUEUEFILE.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/* Identifies a file created by KISS_QUEUEFILE_Open() ("KQUE") */
+#define KISS_QUEUEFILE_MAGIC 0x4555514B
+#define KISS_QUEUEFILE_VERSION 1
+
+/* Layout of the start of the file. The queue storage follows at DataOffset */
+typedef struct {
+    KISS_UINT Magic;
+    KISS_UINT Version;
+    KISS_UINT HeaderSize; /* sizeof(KISS_QUEUEFILE_HEADER), guards against ABI changes */
+    KISS_UINT DataOffset;
+    KISS_UINT16 SyncPolicy;
+    KISS_QUEUE Queue;
+} KISS_QUEUEFILE_HEADER;
+
+#if defined(__unix__) || defined(__APPLE__)
+/* Internal function to write back the header and Len bytes of storage at offset o according to the sync policy */
+static void __sync(KISS_QUEUEFILE* pQF, KISS_UINT o, KISS_UINT Len);
+/* Internal function to check that an existing file holds a consistent queue. Returns 0 if it does */
+static int __check_header(const KISS_QUEUEFILE_HEADER* pHdr, uint64_t FileSize);
+#endif
+
+/* ===============================================================================
+* Name: KISS_QUEUEFILE_Open()
+* Description: Map a file backed queue, creating the file if necessary.
+* Parameters:   [O] pQF - Pointer to the file backed queue
+*               [I] pPath - Path of the file
+*               [I] Size - Size (in bytes) of the queue storage for a new file.
+*               [I] Alignment - Payload alignment for a new file, see KISS_QUEUE_CreateEx().
+*               [I] SyncPolicy - KISS_QUEUEFILE_SYNC_* policy for a new file.
+* Return: int - Returns 0 on success, non-zero if the file can't be created or mapped,
+*               or exists but does not contain a queue.
+* Caution/Notes: When the file already holds a queue, Size, Alignment and SyncPolicy
+*                are taken from the file and the pending items are kept. An item
+*                reserved but not committed, or locked by KISS_QUEUE_GetPtr(), when
+*                the file was last closed is released. A file whose queue state
+*                does not fit its storage is rejected rather than repaired.
+*                Always fails on platforms without POSIX mmap().
+================================================================================== */
+int KISS_QUEUEFILE_Open(KISS_QUEUEFILE* pQF, const char* pPath, KISS_UINT Size, KISS_UINT16 Alignment, KISS_UINT16 SyncPolicy) {
+    KISS_ASSERT(pQF != NULL, "Queue must be a valid pointer");
+    KISS_ASSERT(pPath != NULL, "Path must be a valid pointer");
+    KISS_MEMSET(pQF, 0, sizeof(KISS_QUEUEFILE));
+    pQF->fd = -1;
+#if defined(__unix__) || defined(__APPLE__)
+    const KISS_UINT DataOffset = KISS_ALIGN_UP((KISS_UINT)sizeof(KISS_QUEUEFILE_HEADER), KISS_CACHELINE_SIZE);
+    struct stat st;
+    int fd = open(pPath, O_RDWR | O_CREAT, 0600);
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        if (fd >= 0) {
+            close(fd);
+        }
+        return 1;
+    }
+    const int IsNew = (st.st_size == 0);
+    if (IsNew) {
+        if (ftruncate(fd, (off_t)DataOffset + Size) != 0) {
+            close(fd);
+            return 1;
+        }
+        st.st_size = (off_t)DataOffset + Size;
+    }
+    else if ((size_t)st.st_size < DataOffset) {
+        close(fd);
+        return 1;
+    }
+    uint8_t* pMap = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (pMap == MAP_FAILED) {
+        close(fd);
+        return 1;
+    }
+    KISS_QUEUEFILE_HEADER* pHdr = (KISS_QUEUEFILE_HEADER*)pMap;
+    if (IsNew) {
+        pHdr->Magic = KISS_QUEUEFILE_MAGIC;
+        pHdr->Version = KISS_QUEUEFILE_VERSION;
+        pHdr->HeaderSize = sizeof(KISS_QUEUEFILE_HEADER);
+        pHdr->DataOffset = DataOffset;
+        pHdr->SyncPolicy = SyncPolicy;
+        KISS_QUEUE_CreateEx(&pHdr->Queue, pMap + DataOffset, Size, Alignment, 0);
+    }
+    else if (__check_header(pHdr, (uint64_t)st.st_size) != 0) {
+        munmap(pMap, (size_t)st.st_size);
+        close(fd);
+        return 1;
+    }
+    else {
+        /* Only the buffer pointer is position dependent */
+        pHdr->Queue.pBuffer = pMap + pHdr->DataOffset;
+        pHdr->Queue.NumReserved = 0;
+        pHdr->Queue.UseCount = 0;
+    }
+    pQF->pQ = &pHdr->Queue;
+    pQF->pMap = pMap;
+    pQF->MapSize = (KISS_UINT)st.st_size;
+    pQF->SyncPolicy = pHdr->SyncPolicy;
+    pQF->fd = fd;
+    if (IsNew) {
+        __sync(pQF, 0, 0);
+    }
+    return 0;
+#else
+    (void)Size;
+    (void)Alignment;
+    (void)SyncPolicy;
+    return 1;
+#endif
+}
+
+/* ===============================================================================
+* Name: KISS_QUEUEFILE_Close()
+* Description: Write back and unmap the queue.
+* Parameters: [I/O] pQF - Pointer to the file backed queue
+* Return: None
+* Caution/Notes: The file is kept so it can be reopened with KISS_QUEUEFILE_Open().
+================================================================================== */
+void KISS_QUEUEFILE_Close(KISS_QUEUEFILE* pQF) {
+    KISS_ASSERT(pQF != NULL, "Queue must be a valid pointer");
+#if defined(__unix__) || defined(__APPLE__)
+    if (pQF->pMap != NULL) {
+        if (pQF->SyncPolicy != KISS_QUEUEFILE_SYNC_NONE) {
+            msync(pQF->pMap, pQF->MapSize, MS_SYNC);
+        }
+        munmap(pQF->pMap, pQF->MapSize);
+    }
+    if (pQF->fd >= 0) {
+        close(pQF->fd);
+    }
+#endif
+    KISS_MEMSET(pQF, 0, sizeof(KISS_QUEUEFILE));
+    pQF->fd = -1;
+}
+
+/* ===============================================================================
+* Name: KISS_QUEUEFILE_GetQueue()
+* Description: Get the queue stored in the file.
+* Parameters: [I] pQF - Pointer to the file backed queue
+* Return: KISS_QUEUE* - Pointer to the queue inside the mapping, NULL if not open.
+* Caution/Notes: Changes made directly on the queue are only written back according
+*                to the sync policy by the next KISS_QUEUEFILE_* call.
+================================================================================== */
+KISS_QUEUE* KISS_QUEUEFILE_GetQueue(const KISS_QUEUEFILE* pQF) {
+    KISS_ASSERT(pQF != NULL, "Queue must be a valid pointer");
+    return pQF->pQ;
+}
+
+/* ===============================================================================
+* Name: KISS_QUEUEFILE_Put()
+* Description: Put an item to the end of the queue and write it back.
+* Parameters: [I/O] pQF - Pointer to the file backed queue
+*               [I] pSrc - Pointer to data to add to queue
+*               [I] Size - Size of data to add to queue
+* Return: int - Returns 0 on success.
+* Caution/Notes: With KISS_QUEUEFILE_SYNC_FULL the item is on disk when this returns.
+================================================================================== */
+int KISS_QUEUEFILE_Put(KISS_QUEUEFILE* pQF, const void* pSrc, KISS_UINT Size) {
+    KISS_ASSERT(pQF != NULL && pQF->pQ != NULL, "Queue must be open");
+    void* pDest = KISS_QUEUE_Alloc(pQF->pQ, Size);
+    if (pDest != NULL) {
+        KISS_MEMCPY(pDest, pSrc, Size);
+        return KISS_QUEUEFILE_Commit(pQF, Size);
+    }
+    return 1;
+}
+
+/* ===============================================================================
+* Name: KISS_QUEUEFILE_Commit()
+* Description: Add the item reserved by KISS_QUEUE_Alloc() to the queue and write it back.
+* Parameters: [I/O] pQF - Pointer to the file backed queue
+*               [I] Size - Final size of the item, see KISS_QUEUE_Commit().
+* Return: int - Returns 0 on success.
+* Caution/Notes: None
+================================================================================== */
+int KISS_QUEUEFILE_Commit(KISS_QUEUEFILE* pQF, KISS_UINT Size) {
+    KISS_ASSERT(pQF != NULL && pQF->pQ != NULL, "Queue must be open");
+    /* The reservation is cleared by KISS_QUEUE_Commit(), which also updates the
+       link in the header of the previous tail */
+    const KISS_BOOL HasPrev = (pQF->pQ->NumElements > 0);
+    const KISS_UINT oPrev = pQF->pQ->oTail;
+    const KISS_UINT oItem = pQF->pQ->oReserved;
+    const KISS_UINT NumReserved = pQF->pQ->NumReserved;
+    /* Items of a file backed queue never use compact headers, so every header has the reserved item's size */
+    const KISS_UINT HdrSize = pQF->pQ->ReservedHdr;
+    if (KISS_QUEUE_Commit(pQF->pQ, Size) == 0) {
+#if defined(__unix__) || defined(__APPLE__)
+        __sync(pQF, oItem, NumReserved);
+        if (HasPrev) {
+            __sync(pQF, oPrev, HdrSize);
+        }
+        __sync(pQF, 0, 0);
+#endif
+        return 0;
+    }
+    return 1;
+}
+
+/* ===============================================================================
+* Name: KISS_QUEUEFILE_Purge()
+* Description: Remove the top most element from the queue and write back the change.
+* Parameters: [I/O] pQF - Pointer to the file backed queue
+* Return: None
+* Caution/Notes: The element should have been retrieved first by KISS_QUEUE_GetPtr()
+================================================================================== */
+void KISS_QUEUEFILE_Purge(KISS_QUEUEFILE* pQF) {
+    KISS_ASSERT(pQF != NULL && pQF->pQ != NULL, "Queue must be open");
+    KISS_QUEUE_Purge(pQF->pQ);
+#if defined(__unix__) || defined(__APPLE__)
+    __sync(pQF, 0, 0);
+#endif
+}
+
+/* ===============================================================================
+* Name: KISS_QUEUEFILE_Sync()
+* Description: Write back the whole file and wait for completion.
+* Parameters: [I/O] pQF - Pointer to the file backed queue
+* Return: int - Returns 0 on success.
+* Caution/Notes: Useful with KISS_QUEUEFILE_SYNC_NONE/ASYNC to create explicit
+*                durability points, e.g. after a batch of items.
+================================================================================== */
+int KISS_QUEUEFILE_Sync(KISS_QUEUEFILE* pQF) {
+    KISS_ASSERT(pQF != NULL, "Queue must be a valid pointer");
+#if defined(__unix__) || defined(__APPLE__)
+    if (pQF->pMap != NULL && msync(pQF->pMap, pQF->MapSize, MS_SYNC) == 0) {
+        return 0;
+    }
+#endif
+    return 1;
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+static void __sync(KISS_QUEUEFILE* pQF, KISS_UINT o, KISS_UINT Len) {
+    if (pQF->SyncPolicy == KISS_QUEUEFILE_SYNC_NONE) {
+        return;
+    }
+    const int Flags = (pQF->SyncPolicy == KISS_QUEUEFILE_SYNC_FULL) ? MS_SYNC : MS_ASYNC;
+    const uintptr_t PageSize = (uintptr_t)sysconf(_SC_PAGESIZE);
+    /* Len == 0 selects the file header holding the queue state */
+    const uintptr_t Start = (Len == 0) ? (uintptr_t)pQF->pMap : (uintptr_t)&pQF->pQ->pBuffer[o];
+    const uintptr_t End = (Len == 0) ? Start + sizeof(KISS_QUEUEFILE_HEADER) : Start + Len;
+    const uintptr_t PageStart = KISS_ALIGN_DOWN(Start, PageSize);
+    msync((void*)PageStart, (size_t)(End - PageStart), Flags);
+}
+
+static int __check_header(const KISS_QUEUEFILE_HEADER* pHdr, uint64_t FileSize) {
+    const KISS_QUEUE* pQ = &pHdr->Queue;
+    if (pHdr->Magic != KISS_QUEUEFILE_MAGIC || pHdr->Version != KISS_QUEUEFILE_VERSION ||
+        pHdr->HeaderSize != sizeof(KISS_QUEUEFILE_HEADER) ||
+        (uint64_t)pHdr->DataOffset + pQ->TotalSize > FileSize) {
+        return 1;
+    }
+    /* The file was created with KISS_QUEUE_CreateEx(..., 0) */
+    if (!KISS_IS_POW2(pQ->Alignment) || pQ->Flags != 0 || pQ->NumElements > pQ->TotalSize) {
+        return 1;
+    }
+    /* Only an empty queue, purged up to the end of the buffer, has offsets at TotalSize */
+    const KISS_UINT oMax = (pQ->NumElements > 0) ? pQ->TotalSize - 1 : pQ->TotalSize;
+    return (pQ->oHead > oMax || pQ->oTail > oMax) ? 1 : 0;
+}
+#endif
@@ -0,0 +1,84 @@
+/*================================================================================
+*   zlib/libpng license
+*
+*   Copyright (c) 2021. Denis Hilliard
+*
+*   This software is provided 'as-is', without any express or implied warranty.
+*    In no event will the authors be held liable for any damages arising from the
+*    use of this software.
+*
+*    Permission is granted to anyone to use this software for any purpose,
+*    including commercial applications, and to alter it and redistribute it
+*    freely, subject to the following restrictions:
+*
+*        1. The origin of this software must not be misrepresented; you must not
+*        claim that you wrote the original software. If you use this software in a
+*        product, an acknowledgment in the product documentation would be
+*        appreciated but is not required.
+*
+*        2. Altered source versions must be plainly marked as such, and must not
+*        be misrepresented as being the original software.
+*
+*        3. This notice may not be removed or altered from any source
+*        distribution.
+*
+*   Component: File Backed Queue
+*   File: KISS_QUEUEFILE.h
+*   Description:  This file implements a KISS_QUEUE whose state and storage live
+*                 in a memory mapped file so pending items survive a restart.
+*   Caution/Notes:  Requires POSIX mmap().
+*=================================================================================*/
+#ifndef _KISS_QUEUEFILE_H_
+#define _KISS_QUEUEFILE_H_
+
+#include "KISS_Common.h"
+#include "KISS_QUEUE.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Sync policies for KISS_QUEUEFILE_Open() */
+/* Leave write back to the OS. Items survive a process crash but not a system crash */
+#define KISS_QUEUEFILE_SYNC_NONE 0
+/* Schedule write back with msync(MS_ASYNC) after each change */
+#define KISS_QUEUEFILE_SYNC_ASYNC 1
+/* Wait for write back with msync(MS_SYNC) after each change. Items survive a system crash */
+#define KISS_QUEUEFILE_SYNC_FULL 2
+
+/*
+KISS_QUEUEFILE maps a file containing a KISS_QUEUE header followed by its storage. KISS_QUEUE only
+keeps offsets inside its buffer, so reopening the file just remaps it and fixes up pBuffer: pending
+items are available again straight away without replaying them.
+Items are added and removed through the KISS_QUEUEFILE_* functions, which apply the sync policy
+chosen when the file was created. All other KISS_QUEUE functions can be used on the queue
+returned by KISS_QUEUEFILE_GetQueue().
+The file holds the native KISS_QUEUE layout so it can only be reopened by a build for the same ABI.
+*/
+typedef struct {
+    KISS_QUEUE* pQ; /* Queue header inside the mapping */
+    void* pMap;
+    KISS_UINT MapSize;
+    KISS_UINT16 SyncPolicy;
+    int fd;
+} KISS_QUEUEFILE;
+
+/* Open the queue stored in pPath, creating it with Size bytes of storage if it doesn't exist. Returns 0 on success */
+int KISS_QUEUEFILE_Open(KISS_QUEUEFILE* pQF, const char* pPath, KISS_UINT Size, KISS_UINT16 Alignment, KISS_UINT16 SyncPolicy);
+/* Write back and unmap the queue. The file is kept */
+void KISS_QUEUEFILE_Close(KISS_QUEUEFILE* pQF);
+/* Get the queue stored in the file */
+KISS_QUEUE* KISS_QUEUEFILE_GetQueue(const KISS_QUEUEFILE* pQF);
+
+/* These functions behave like their KISS_QUEUE counterparts and apply the sync policy. They return 0 on success */
+int KISS_QUEUEFILE_Put(KISS_QUEUEFILE* pQF, const void* pSrc, KISS_UINT Size);
+/* Publish an item reserved with KISS_QUEUE_Alloc() on the queue from KISS_QUEUEFILE_GetQueue() */
+int KISS_QUEUEFILE_Commit(KISS_QUEUEFILE* pQF, KISS_UINT Size);
+void KISS_QUEUEFILE_Purge(KISS_QUEUEFILE* pQF);
+/* Write back the whole file and wait for completion, whatever the sync policy */
+int KISS_QUEUEFILE_Sync(KISS_QUEUEFILE* pQF);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
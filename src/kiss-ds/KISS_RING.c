@@ -29,6 +29,21 @@
 *=================================================================================*/
 #include "KISS_RING.h"
 
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/uio.h>
+#endif
+
+/* Internal helpers hiding the difference between the modulo and power of 2 index arithmetic */
+static KISS_UINT __ring_count(const KISS_RING* pRB);
+static KISS_UINT __ring_slot(const KISS_RING* pRB, KISS_UINT o);
+static void __ring_push_tail(KISS_RING* pRB, KISS_UINT Count);
+static void __ring_push_head(KISS_RING* pRB);
+static void __ring_pop_head(KISS_RING* pRB, KISS_UINT Count);
+/* Internal function to drop the oldest elements of a KISS_RING_FLAG_OVERWRITE ring buffer. Returns 0 on success */
+static KISS_BOOL __ring_drop_oldest(KISS_RING* pRB, KISS_UINT Count);
+/* Internal function to split Count slots starting at offset o into at most two contiguous spans */
+static KISS_UINT __ring_spans(const KISS_RING* pRB, KISS_UINT o, KISS_UINT Count, KISS_RING_SPAN pSpans[2]);
+
 /* ===============================================================================
 * Name: KISS_RING_Create()
 * Description: Create a ring buffer of fixed size items. 
@@ -38,12 +53,33 @@
 *               [I] pBuffer - Pointer to buffer to use for storage
 * Return: None
 * Caution/Notes: Memory pointed to by pBuffer must be at least sizeofMsg * maxnofmsg bytes.
+*                A power of 2 maxnofmsg automatically selects the masked index arithmetic.
 ================================================================================== */
 void KISS_RING_Create(KISS_RING* pRB, KISS_UINT16 sizeofMsg, KISS_UINT maxnofmsg, void* pBuffer) {
+    KISS_RING_CreateEx(pRB, sizeofMsg, maxnofmsg, pBuffer, 0);
+}
+
+/* ===============================================================================
+* Name: KISS_RING_CreateEx()
+* Description: Create a ring buffer of fixed size items with additional options.
+* Parameters:   [O] pRB - Pointer to ring buffer
+*               [I] sizeofMsg - Size of each individual message
+*               [I] maxnofmsg - Number of messages in the buffer
+*               [I] pBuffer - Pointer to buffer to use for storage
+*               [I] Flags - Combination of KISS_RING_FLAG_* options
+* Return: None
+* Caution/Notes: Memory pointed to by pBuffer must be at least sizeofMsg * maxnofmsg bytes.
+*                KISS_RING_FLAG_POW2 requires maxnofmsg to be a power of 2.
+*                Unless KISS_RING_FLAG_MODULO is given, KISS_RING_FLAG_POW2 is
+*                selected automatically when maxnofmsg is a power of 2.
+================================================================================== */
+void KISS_RING_CreateEx(KISS_RING* pRB, KISS_UINT16 sizeofMsg, KISS_UINT maxnofmsg, void* pBuffer, KISS_UINT16 Flags) {
     KISS_ASSERT(pRB != NULL, "Ring Buffer must be a valid pointer");
     KISS_ASSERT(pBuffer != NULL, "Storage buffer must not be NULL");
     KISS_ASSERT(sizeofMsg > 0, "The size of each individual message cannot be zero");
     KISS_ASSERT(maxnofmsg > 0, "The buffer must have space for at least one element");
+    KISS_ASSERT(!(Flags & KISS_RING_FLAG_POW2) || KISS_IS_POW2(maxnofmsg), "The number of messages must be a power of 2");
+    KISS_ASSERT(!(Flags & KISS_RING_FLAG_POW2) || !(Flags & KISS_RING_FLAG_MODULO), "KISS_RING_FLAG_POW2 and KISS_RING_FLAG_MODULO are exclusive");
     KISS_MEMSET(pRB, 0, sizeof(KISS_RING));
     pRB->pBuffer = pBuffer;
     pRB->MaxCount = maxnofmsg;
@@ -51,8 +87,15 @@ void KISS_RING_Create(KISS_RING* pRB, KISS_UINT16 sizeofMsg, KISS_UINT maxnofmsg
     pRB->oHead = 0;
     pRB->oTail = 0;
     pRB->NumUsed = 0;
+    pRB->NumReserved = 0;
+    pRB->NumDropped = 0;
     pRB->UseCount = 0;
-
+    pRB->Flags = Flags;
+    if (!(Flags & KISS_RING_FLAG_MODULO) && KISS_IS_POW2(maxnofmsg)) {
+        pRB->Flags |= KISS_RING_FLAG_POW2;
+    }
+    /* Indices of the modulo arithmetic are always in range, so they map to themselves */
+    pRB->Mask = (pRB->Flags & KISS_RING_FLAG_POW2) ? maxnofmsg - 1 : 0xFFFFFFFF;
 }
 
 /* ===============================================================================
@@ -70,7 +113,11 @@ void KISS_RING_Delete(KISS_RING* pRB) {
     pRB->oHead = 0;
     pRB->oTail = 0;
     pRB->NumUsed = 0;
+    pRB->NumReserved = 0;
+    pRB->NumDropped = 0;
+    pRB->Mask = 0;
     pRB->UseCount = 0;
+    pRB->Flags = 0;
 }
 
 /* ===============================================================================
@@ -93,15 +140,23 @@ void KISS_RING_Clear(KISS_RING* pRB) {
 *               [I] pElement - Pointer to the element to add at the back of the ring buffer.
 * Return: KISS_BOOL - Returns 0 on success
 * Caution/Notes: Ownership of pElement is borrowed until function returns.
+*                With KISS_RING_FLAG_OVERWRITE a full ring buffer drops its oldest
+*                element, unless it is locked by KISS_RING_GetPtr().
 ================================================================================== */
 KISS_BOOL KISS_RING_Put(KISS_RING* pRB, const void* pElement) {
     KISS_ASSERT(pRB != NULL, "Ring Buffer must be a valid pointer");
 
-    if (pRB->NumUsed < pRB->MaxCount) {
-        void* pDest = &pRB->pBuffer[pRB->oTail * pRB->ItemSize];
+    if ((pRB->Flags & KISS_RING_FLAG_POW2) && pRB->oTail - pRB->oHead < pRB->MaxCount) {
+        /* Fast path: a single mode test, then plain masked index arithmetic */
+        KISS_MEMCPY(&pRB->pBuffer[(pRB->oTail & pRB->Mask) * pRB->ItemSize], pElement, pRB->ItemSize);
+        pRB->oTail++;
+        return 0;
+    }
+
+    if (__ring_count(pRB) < pRB->MaxCount || __ring_drop_oldest(pRB, 1) == 0) {
+        void* pDest = &pRB->pBuffer[__ring_slot(pRB, pRB->oTail) * pRB->ItemSize];
         KISS_MEMCPY(pDest, pElement, pRB->ItemSize);
-        pRB->oTail = (pRB->oTail + 1) % pRB->MaxCount;
-        pRB->NumUsed++;
+        __ring_push_tail(pRB, 1);
         return 0;
     }
 
@@ -123,10 +178,9 @@ KISS_BOOL KISS_RING_Put(KISS_RING* pRB, const void* pElement) {
 KISS_BOOL KISS_RING_Put1(KISS_RING* pRB, const char* pElement) {
     KISS_ASSERT(pRB != NULL, "Ring Buffer must be a valid pointer");
 
-    if (pRB->NumUsed < pRB->MaxCount) {
-        pRB->pBuffer[pRB->oTail * pRB->ItemSize] = (uint8_t)*pElement;
-        pRB->oTail = (pRB->oTail + 1) % pRB->MaxCount;
-        pRB->NumUsed++;
+    if (__ring_count(pRB) < pRB->MaxCount || __ring_drop_oldest(pRB, 1) == 0) {
+        pRB->pBuffer[__ring_slot(pRB, pRB->oTail) * pRB->ItemSize] = (uint8_t)*pElement;
+        __ring_push_tail(pRB, 1);
         return 0;
     }
 
@@ -145,12 +199,11 @@ KISS_BOOL KISS_RING_Put1(KISS_RING* pRB, const char* pElement) {
 KISS_BOOL KISS_RING_PutFront(KISS_RING* pRB, const void* pElement) {
     KISS_ASSERT(pRB != NULL, "Ring Buffer must be a valid pointer");
 
-    if (pRB->NumUsed < pRB->MaxCount) {
+    if (__ring_count(pRB) < pRB->MaxCount) {
         /* Instead of adjusting the tail offset KISS_RING_PutFront1 adjusts the head offset */
-        pRB->oHead = (pRB->oHead + pRB->MaxCount - 1) % pRB->MaxCount;
-        void* pDest = &pRB->pBuffer[pRB->oHead * pRB->ItemSize];
+        __ring_push_head(pRB);
+        void* pDest = &pRB->pBuffer[__ring_slot(pRB, pRB->oHead) * pRB->ItemSize];
         KISS_MEMCPY(pDest, pElement, pRB->ItemSize);
-        pRB->NumUsed++;
         return 0;
     }
     return 1;
@@ -167,11 +220,10 @@ KISS_BOOL KISS_RING_PutFront(KISS_RING* pRB, const void* pElement) {
 KISS_BOOL KISS_RING_PutFront1(KISS_RING* pRB, const char* pElement) {
     KISS_ASSERT(pRB != NULL, "Ring Buffer must be a valid pointer");
 
-    if (pRB->NumUsed < pRB->MaxCount) {
+    if (__ring_count(pRB) < pRB->MaxCount) {
         /* Instead of adjusting the tail offset KISS_RING_PutFront1 adjusts the head offset */
-        pRB->oHead = (pRB->oHead + pRB->MaxCount - 1) % pRB->MaxCount;
-        pRB->pBuffer[pRB->oHead * pRB->ItemSize] = (uint8_t)*pElement;
-        pRB->NumUsed++;
+        __ring_push_head(pRB);
+        pRB->pBuffer[__ring_slot(pRB, pRB->oHead) * pRB->ItemSize] = (uint8_t)*pElement;
         return 0;
     }
     return 1;
@@ -190,12 +242,17 @@ KISS_BOOL KISS_RING_PutFront1(KISS_RING* pRB, const char* pElement) {
 KISS_BOOL KISS_RING_Get(KISS_RING* pRB, void* pData) {
     KISS_ASSERT(pRB != NULL, "Ring Buffer must be a valid pointer");
 
-    if (pRB->NumUsed > 0 && pData != NULL) {
-        int oNext = (pRB->oHead + 1) % pRB->MaxCount;
-        void* pSrc = &pRB->pBuffer[pRB->oHead * pRB->ItemSize];
+    if ((pRB->Flags & KISS_RING_FLAG_POW2) && pRB->oTail != pRB->oHead && pData != NULL) {
+        /* Fast path: a single mode test, then plain masked index arithmetic */
+        KISS_MEMCPY(pData, &pRB->pBuffer[(pRB->oHead & pRB->Mask) * pRB->ItemSize], pRB->ItemSize);
+        pRB->oHead++;
+        return 0;
+    }
+
+    if (__ring_count(pRB) > 0 && pData != NULL) {
+        void* pSrc = &pRB->pBuffer[__ring_slot(pRB, pRB->oHead) * pRB->ItemSize];
         KISS_MEMCPY(pData, pSrc, pRB->ItemSize);
-        pRB->oHead = oNext;
-        pRB->NumUsed--;
+        __ring_pop_head(pRB, 1);
         return 0;
     }
     return 1;
@@ -212,11 +269,9 @@ KISS_BOOL KISS_RING_Get(KISS_RING* pRB, void* pData) {
 KISS_BOOL KISS_RING_Get1(KISS_RING* pRB, char* pData) {
     KISS_ASSERT(pRB != NULL, "Ring Buffer must be a valid pointer");
 
-    if (pRB->NumUsed > 0 && pData != NULL) {
-        int oNext = (pRB->oHead + 1) % pRB->MaxCount;
-        *pData = (char)pRB->pBuffer[pRB->oHead * pRB->ItemSize];
-        pRB->oHead = oNext;
-        pRB->NumUsed--;
+    if (__ring_count(pRB) > 0 && pData != NULL) {
+        *pData = (char)pRB->pBuffer[__ring_slot(pRB, pRB->oHead) * pRB->ItemSize];
+        __ring_pop_head(pRB, 1);
         return 0;
     }
     return 1;
@@ -224,6 +279,76 @@ KISS_BOOL KISS_RING_Get1(KISS_RING* pRB, char* pData) {
 /*
 * 
 */
+/* ===============================================================================
+* Name: KISS_RING_PutN()
+* Description:  Put up to Count elements to the end of the ring buffer.
+* Parameters:   [I/O] pRB - Pointer to ring buffer
+*               [I] pElements - Pointer to an array of elements to add at the back of the ring buffer.
+*               [I] Count - Number of elements in the array.
+* Return: KISS_UINT - Number of elements added to the ring buffer.
+* Caution/Notes: Elements are copied with at most two KISS_MEMCPY calls, one before
+*                and one after the wrap point, and the offsets are updated once.
+*                Ownership of pElements is borrowed until function returns.
+*                With KISS_RING_FLAG_OVERWRITE the oldest elements are dropped to
+*                make room, so only the newest MaxCount elements are kept.
+================================================================================== */
+KISS_UINT KISS_RING_PutN(KISS_RING* pRB, const void* pElements, KISS_UINT Count) {
+    KISS_ASSERT(pRB != NULL, "Ring Buffer must be a valid pointer");
+    const KISS_UINT NumFree = pRB->MaxCount - __ring_count(pRB);
+
+    if (Count > NumFree && pElements != NULL && __ring_drop_oldest(pRB, KISS_MIN(Count, pRB->MaxCount) - NumFree) == 0) {
+        if (Count > pRB->MaxCount) {
+            /* Elements which would be overwritten by this call are skipped altogether */
+            pRB->NumDropped += Count - pRB->MaxCount;
+            pElements = (const uint8_t*)pElements + (size_t)(Count - pRB->MaxCount) * pRB->ItemSize;
+            Count = pRB->MaxCount;
+        }
+    }
+    const KISS_UINT Num = KISS_MIN(Count, pRB->MaxCount - __ring_count(pRB));
+
+    if (Num > 0 && pElements != NULL) {
+        const KISS_UINT oSlot = __ring_slot(pRB, pRB->oTail);
+        const KISS_UINT NumFirst = KISS_MIN(Num, pRB->MaxCount - oSlot);
+        KISS_MEMCPY(&pRB->pBuffer[oSlot * pRB->ItemSize], pElements, (size_t)NumFirst * pRB->ItemSize);
+        if (Num > NumFirst) {
+            /* Remaining elements go to the start of the buffer */
+            KISS_MEMCPY(pRB->pBuffer, (const uint8_t*)pElements + (size_t)NumFirst * pRB->ItemSize, (size_t)(Num - NumFirst) * pRB->ItemSize);
+        }
+        __ring_push_tail(pRB, Num);
+        return Num;
+    }
+    return 0;
+}
+
+/* ===============================================================================
+* Name: KISS_RING_GetN()
+* Description: Get up to Count elements from the front of the ring buffer.
+* Parameters:   [I/O] pRB - Pointer to the ring buffer.
+*               [O] pData - Pointer to memory to receive the elements.
+*               [I] Count - Maximum number of elements to retrieve.
+* Return: KISS_UINT - Number of elements removed from the ring buffer.
+* Caution/Notes: Elements are copied with at most two KISS_MEMCPY calls, one before
+*                and one after the wrap point, and the offsets are updated once.
+*                The memory pointed to by pData should be at least Count * ItemSize bytes long
+================================================================================== */
+KISS_UINT KISS_RING_GetN(KISS_RING* pRB, void* pData, KISS_UINT Count) {
+    KISS_ASSERT(pRB != NULL, "Ring Buffer must be a valid pointer");
+    const KISS_UINT Num = KISS_MIN(Count, __ring_count(pRB));
+
+    if (Num > 0 && pData != NULL) {
+        const KISS_UINT oSlot = __ring_slot(pRB, pRB->oHead);
+        const KISS_UINT NumFirst = KISS_MIN(Num, pRB->MaxCount - oSlot);
+        KISS_MEMCPY(pData, &pRB->pBuffer[oSlot * pRB->ItemSize], (size_t)NumFirst * pRB->ItemSize);
+        if (Num > NumFirst) {
+            /* Remaining elements come from the start of the buffer */
+            KISS_MEMCPY((uint8_t*)pData + (size_t)NumFirst * pRB->ItemSize, pRB->pBuffer, (size_t)(Num - NumFirst) * pRB->ItemSize);
+        }
+        __ring_pop_head(pRB, Num);
+        return Num;
+    }
+    return 0;
+}
+
 /* ===============================================================================
 * Name: KISS_RING_Peek()
 * Description: Get the top-most element of the ring buffer without removing it.
@@ -236,8 +361,8 @@ KISS_BOOL KISS_RING_Get1(KISS_RING* pRB, char* pData) {
 ================================================================================== */
 KISS_BOOL KISS_RING_Peek(const KISS_RING* pRB, void* pDest) {
     KISS_ASSERT(pRB != NULL, "Ring Buffer must be a valid pointer");
-    if (pRB->NumUsed > 0) {
-        void* pSrc = &pRB->pBuffer[pRB->oHead * pRB->ItemSize];
+    if (__ring_count(pRB) > 0) {
+        void* pSrc = &pRB->pBuffer[__ring_slot(pRB, pRB->oHead) * pRB->ItemSize];
         KISS_MEMCPY(pDest, pSrc, pRB->ItemSize);
         return 0;
     }
@@ -255,9 +380,9 @@ KISS_BOOL KISS_RING_Peek(const KISS_RING* pRB, void* pDest) {
 ================================================================================== */
 KISS_BOOL KISS_RING_GetPtr(KISS_RING* pRB, void** ppDest) {
     KISS_ASSERT(pRB != NULL, "Ring Buffer must be a valid pointer");
-    if (pRB->NumUsed > 0 && ppDest != NULL) {
+    if (__ring_count(pRB) > 0 && ppDest != NULL) {
         pRB->UseCount++;
-        *ppDest = &pRB->pBuffer[pRB->oHead * pRB->ItemSize];
+        *ppDest = &pRB->pBuffer[__ring_slot(pRB, pRB->oHead) * pRB->ItemSize];
         return 0;
     }
     return 1;
@@ -276,11 +401,182 @@ void KISS_RING_Purge(KISS_RING* pRB) {
         pRB->UseCount--;
     }
     if (pRB->UseCount == 0) {
-        if (pRB->NumUsed > 0) {
-            pRB->oHead = (pRB->oHead + 1) % pRB->MaxCount;
-            pRB->NumUsed--;
+        if (__ring_count(pRB) > 0) {
+            __ring_pop_head(pRB, 1);
+        }
+    }
+}
+
+/* ===============================================================================
+* Name: KISS_RING_PeekAt()
+* Description: Get a copy of an element of the ring buffer without removing it.
+* Parameters:   [I] pRB - Pointer to the ring buffer.
+*               [I] Index - Position of the element, 0 being the front of the ring buffer.
+*               [O] pDest - Pointer to buffer to receive the element.
+* Return: KISS_BOOL - Returns 0 on success, non-zero if Index is out of range.
+* Caution/Notes: The memory pointed to by pDest should be at least ItemSize bytes long
+================================================================================== */
+KISS_BOOL KISS_RING_PeekAt(const KISS_RING* pRB, KISS_UINT Index, void* pDest) {
+    void* pSrc = NULL;
+    if (pDest != NULL && KISS_RING_PeekPtrAt(pRB, Index, &pSrc) == 0) {
+        KISS_MEMCPY(pDest, pSrc, pRB->ItemSize);
+        return 0;
+    }
+    return 1;
+}
+
+/* ===============================================================================
+* Name: KISS_RING_PeekPtrAt()
+* Description: Get a pointer to an element of the ring buffer without removing it.
+* Parameters:   [I] pRB - Pointer to the ring buffer.
+*               [I] Index - Position of the element, 0 being the front of the ring buffer.
+*               [O] ppDest - Pointer to pointer to the element.
+* Return: KISS_BOOL - Returns 0 on success, non-zero if Index is out of range.
+* Caution/Notes: Unlike KISS_RING_GetPtr() this does not lock the ring buffer. The
+*                pointer is only valid until the element is removed or overwritten.
+================================================================================== */
+KISS_BOOL KISS_RING_PeekPtrAt(const KISS_RING* pRB, KISS_UINT Index, void** ppDest) {
+    KISS_ASSERT(pRB != NULL, "Ring Buffer must be a valid pointer");
+    if (Index < __ring_count(pRB) && ppDest != NULL) {
+        KISS_UINT oSlot = __ring_slot(pRB, pRB->oHead + Index);
+        if (!(pRB->Flags & KISS_RING_FLAG_POW2) && oSlot >= pRB->MaxCount) {
+            oSlot -= pRB->MaxCount;
         }
+        *ppDest = &pRB->pBuffer[oSlot * pRB->ItemSize];
+        return 0;
     }
+    return 1;
+}
+
+/* ===============================================================================
+* Name: KISS_RING_GetSpans()
+* Description: Describe the elements in the ring buffer as contiguous memory regions
+*              so they can be scanned in place.
+* Parameters: [I] pRB - Pointer to the ring buffer
+*             [O] pSpans - Array of two spans to receive the regions, front first.
+* Return: KISS_UINT - Number of spans filled in: 0 if empty, 2 if the elements wrap
+*                     around the end of the buffer, otherwise 1.
+* Caution/Notes: The ring buffer is not modified. The spans are only valid until the
+*                next call that adds or removes elements.
+================================================================================== */
+KISS_UINT KISS_RING_GetSpans(const KISS_RING* pRB, KISS_RING_SPAN pSpans[2]) {
+    KISS_ASSERT(pRB != NULL, "Ring Buffer must be a valid pointer");
+    KISS_ASSERT(pSpans != NULL, "Spans must be a valid pointer");
+    return __ring_spans(pRB, pRB->oHead, __ring_count(pRB), pSpans);
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+/* ===============================================================================
+* Name: KISS_RING_ReadFd()
+* Description: Read bytes from a file descriptor straight into the free space at the
+*              back of a byte ring buffer.
+* Parameters: [I/O] pRB - Pointer to the ring buffer
+*             [I] fd - File descriptor to read from
+* Return: int - Number of bytes added to the ring buffer, 0 if the ring buffer is full
+*               or fd reached end of file, -1 on error with errno set by readv().
+* Caution/Notes: The ring buffer must have an ItemSize of 1. Both free spans are
+*                filled by a single readv() call. Existing bytes are never overwritten,
+*                even with KISS_RING_FLAG_OVERWRITE.
+================================================================================== */
+int KISS_RING_ReadFd(KISS_RING* pRB, int fd) {
+    KISS_ASSERT(pRB != NULL, "Ring Buffer must be a valid pointer");
+    KISS_ASSERT(pRB->ItemSize == 1, "Only byte ring buffers can be used with a file descriptor");
+    KISS_RING_SPAN spans[2];
+    struct iovec iov[2];
+    const KISS_UINT NumSpans = __ring_spans(pRB, pRB->oTail, pRB->MaxCount - __ring_count(pRB), spans);
+
+    if (NumSpans > 0) {
+        for (KISS_UINT i = 0; i < NumSpans; ++i) {
+            iov[i].iov_base = spans[i].pData;
+            iov[i].iov_len = spans[i].Count;
+        }
+        const ssize_t Num = readv(fd, iov, (int)NumSpans);
+        if (Num > 0) {
+            __ring_push_tail(pRB, (KISS_UINT)Num);
+        }
+        return (int)Num;
+    }
+    return 0;
+}
+
+/* ===============================================================================
+* Name: KISS_RING_WriteFd()
+* Description: Write the bytes at the front of a byte ring buffer straight to a file
+*              descriptor and remove the bytes written.
+* Parameters: [I/O] pRB - Pointer to the ring buffer
+*             [I] fd - File descriptor to write to
+* Return: int - Number of bytes removed from the ring buffer, 0 if it is empty,
+*               -1 on error with errno set by writev().
+* Caution/Notes: The ring buffer must have an ItemSize of 1. Both live spans are
+*                written by a single writev() call, which may be partial.
+*                Must not be called while the front is locked by KISS_RING_GetPtr().
+================================================================================== */
+int KISS_RING_WriteFd(KISS_RING* pRB, int fd) {
+    KISS_ASSERT(pRB != NULL, "Ring Buffer must be a valid pointer");
+    KISS_ASSERT(pRB->ItemSize == 1, "Only byte ring buffers can be used with a file descriptor");
+    KISS_ASSERT(pRB->UseCount == 0, "Ring Buffer is currently in use");
+    KISS_RING_SPAN spans[2];
+    struct iovec iov[2];
+    const KISS_UINT NumSpans = KISS_RING_GetSpans(pRB, spans);
+
+    if (NumSpans > 0) {
+        for (KISS_UINT i = 0; i < NumSpans; ++i) {
+            iov[i].iov_base = spans[i].pData;
+            iov[i].iov_len = spans[i].Count;
+        }
+        const ssize_t Num = writev(fd, iov, (int)NumSpans);
+        if (Num > 0) {
+            __ring_pop_head(pRB, (KISS_UINT)Num);
+        }
+        return (int)Num;
+    }
+    return 0;
+}
+#endif
+
+/* ===============================================================================
+* Name: KISS_RING_Reserve()
+* Description: Get a pointer to free slots at the back of the ring buffer so the
+*              producer can build elements in place.
+* Parameters: [I/O] pRB - Pointer to the ring buffer
+*             [O] ppDest - Pointer to pointer to the first reserved slot.
+*             [I] Count - Maximum number of slots to reserve.
+* Return: KISS_UINT - Number of contiguous slots reserved. 0 if the ring buffer is full.
+* Caution/Notes: The reserved slots stop at the end of the buffer, so fewer than Count
+*                slots may be returned even if the ring buffer has more free space.
+*                The slots are not visible until KISS_RING_Commit() is called and
+*                no other element may be added in between.
+================================================================================== */
+KISS_UINT KISS_RING_Reserve(KISS_RING* pRB, void** ppDest, KISS_UINT Count) {
+    KISS_ASSERT(pRB != NULL, "Ring Buffer must be a valid pointer");
+    const KISS_UINT NumFree = pRB->MaxCount - __ring_count(pRB);
+
+    if (NumFree > 0 && Count > 0 && ppDest != NULL) {
+        const KISS_UINT oSlot = __ring_slot(pRB, pRB->oTail);
+        pRB->NumReserved = KISS_MIN(KISS_MIN(Count, NumFree), pRB->MaxCount - oSlot);
+        *ppDest = &pRB->pBuffer[oSlot * pRB->ItemSize];
+        return pRB->NumReserved;
+    }
+    return 0;
+}
+
+/* ===============================================================================
+* Name: KISS_RING_Commit()
+* Description: Add previously reserved slots to the back of the ring buffer.
+*              Used in conjunction with KISS_RING_Reserve()
+* Parameters: [I/O] pRB - Pointer to the ring buffer
+*             [I] Count - Number of reserved slots to publish.
+* Return: None
+* Caution/Notes: Count may be less than the number of slots reserved. Any remaining
+*                reserved slots are released.
+================================================================================== */
+void KISS_RING_Commit(KISS_RING* pRB, KISS_UINT Count) {
+    KISS_ASSERT(pRB != NULL, "Ring Buffer must be a valid pointer");
+    KISS_ASSERT(Count <= pRB->NumReserved, "Cannot commit more slots than were reserved");
+    if (Count > 0 && Count <= pRB->NumReserved) {
+        __ring_push_tail(pRB, Count);
+    }
+    pRB->NumReserved = 0;
 }
 
 /* ===============================================================================
@@ -292,5 +588,85 @@ void KISS_RING_Purge(KISS_RING* pRB) {
 ================================================================================== */
 int KISS_RING_GetItemCnt(const KISS_RING* pRB) {
     KISS_ASSERT(pRB != NULL, "Ring Buffer must be a valid pointer");
+    return (int)__ring_count(pRB);
+}
+
+/* ===============================================================================
+* Name: KISS_RING_GetDropCnt()
+* Description: Get the number of elements dropped by a KISS_RING_FLAG_OVERWRITE ring buffer.
+* Parameters: [I] pRB - Pointer to the ring buffer
+* Return: KISS_UINT - Number of elements overwritten since the ring buffer was created
+* Caution/Notes: Consumers can compare successive values to detect gaps.
+================================================================================== */
+KISS_UINT KISS_RING_GetDropCnt(const KISS_RING* pRB) {
+    KISS_ASSERT(pRB != NULL, "Ring Buffer must be a valid pointer");
+    return pRB->NumDropped;
+}
+
+static KISS_BOOL __ring_drop_oldest(KISS_RING* pRB, KISS_UINT Count) {
+    /* The head can't be dropped while the consumer holds a pointer to it */
+    if ((pRB->Flags & KISS_RING_FLAG_OVERWRITE) && pRB->UseCount == 0) {
+        __ring_pop_head(pRB, Count);
+        pRB->NumDropped += Count;
+        return 0;
+    }
+    return 1;
+}
+
+static KISS_UINT __ring_count(const KISS_RING* pRB) {
+    if (pRB->Flags & KISS_RING_FLAG_POW2) {
+        return pRB->oTail - pRB->oHead;
+    }
     return pRB->NumUsed;
 }
+
+static KISS_UINT __ring_slot(const KISS_RING* pRB, KISS_UINT o) {
+    return o & pRB->Mask;
+}
+
+static void __ring_push_tail(KISS_RING* pRB, KISS_UINT Count) {
+    if (pRB->Flags & KISS_RING_FLAG_POW2) {
+        pRB->oTail += Count;
+    }
+    else {
+        pRB->oTail = (pRB->oTail + Count) % pRB->MaxCount;
+        pRB->NumUsed += Count;
+    }
+}
+
+static void __ring_push_head(KISS_RING* pRB) {
+    if (pRB->Flags & KISS_RING_FLAG_POW2) {
+        pRB->oHead--;
+    }
+    else {
+        pRB->oHead = (pRB->oHead + pRB->MaxCount - 1) % pRB->MaxCount;
+        pRB->NumUsed++;
+    }
+}
+
+static void __ring_pop_head(KISS_RING* pRB, KISS_UINT Count) {
+    if (pRB->Flags & KISS_RING_FLAG_POW2) {
+        pRB->oHead += Count;
+    }
+    else {
+        pRB->oHead = (pRB->oHead + Count) % pRB->MaxCount;
+        pRB->NumUsed -= Count;
+    }
+}
+
+static KISS_UINT __ring_spans(const KISS_RING* pRB, KISS_UINT o, KISS_UINT Count, KISS_RING_SPAN pSpans[2]) {
+    if (Count == 0) {
+        return 0;
+    }
+    const KISS_UINT oSlot = __ring_slot(pRB, o);
+    const KISS_UINT NumFirst = KISS_MIN(Count, pRB->MaxCount - oSlot);
+    pSpans[0].pData = &pRB->pBuffer[oSlot * pRB->ItemSize];
+    pSpans[0].Count = NumFirst;
+    if (Count > NumFirst) {
+        /* The remaining slots continue at the start of the buffer */
+        pSpans[1].pData = pRB->pBuffer;
+        pSpans[1].Count = Count - NumFirst;
+        return 2;
+    }
+    return 1;
+}
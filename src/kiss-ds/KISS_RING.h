@@ -43,19 +43,41 @@ typedef struct {
     KISS_UINT NumUsed;
     KISS_UINT oHead;
     KISS_UINT oTail;
+    KISS_UINT NumReserved;
+    KISS_UINT NumDropped;
+    KISS_UINT Mask; /* Maps an index to its slot: MaxCount - 1 with KISS_RING_FLAG_POW2, else all ones */
     KISS_UINT16 ItemSize;
     KISS_UINT16 UseCount;
+    KISS_UINT16 Flags;
 
 } KISS_RING;
 
+/* A contiguous run of Count elements starting at pData, see KISS_RING_GetSpans() */
+typedef struct {
+    void* pData;
+    KISS_UINT Count;
+} KISS_RING_SPAN;
+
+/* Flags for KISS_RING_CreateEx() */
+/* MaxCount is a power of 2: indices run freely and are masked, NumUsed is derived from them */
+#define KISS_RING_FLAG_POW2 0x0001
+/* Always use the generic modulo index arithmetic, even if MaxCount is a power of 2 */
+#define KISS_RING_FLAG_MODULO 0x0002
+/* Put/PutN on a full ring buffer overwrite the oldest elements instead of failing */
+#define KISS_RING_FLAG_OVERWRITE 0x0004
+
 /* Create a ring buffer using the buffer as the backing storage */
 void KISS_RING_Create(KISS_RING* pRB, KISS_UINT16 sizeofMsg, KISS_UINT maxnofmsg, void* pBuffer);
+/* Create a ring buffer with the specified KISS_RING_FLAG_* options */
+void KISS_RING_CreateEx(KISS_RING* pRB, KISS_UINT16 sizeofMsg, KISS_UINT maxnofmsg, void* pBuffer, KISS_UINT16 Flags);
 /* Clear the ring buffer to the uninitialised state */
 void KISS_RING_Delete(KISS_RING* pRB);
 /* Remove any pending messages in the ring buffer */
 void KISS_RING_Clear(KISS_RING* pRB);
 /* Get the number of items currently in the ring buffer */
 int KISS_RING_GetItemCnt(const KISS_RING* pRB);
+/* Get the number of elements overwritten since creation (KISS_RING_FLAG_OVERWRITE only) */
+KISS_UINT KISS_RING_GetDropCnt(const KISS_RING* pRB);
 
 /* These functions all return 0 on success */
 KISS_BOOL KISS_RING_Put(KISS_RING* pRB, const void* pElement);
@@ -67,11 +89,107 @@ KISS_BOOL KISS_RING_PutFront1(KISS_RING* pRB, const char* pElement);
 KISS_BOOL KISS_RING_Get(KISS_RING* pRB, void* pData);
 KISS_BOOL KISS_RING_Get1(KISS_RING* pRB, char* pData);
 
+/* Bulk transfer of up to Count elements. These functions return the number of elements transferred */
+KISS_UINT KISS_RING_PutN(KISS_RING* pRB, const void* pElements, KISS_UINT Count);
+KISS_UINT KISS_RING_GetN(KISS_RING* pRB, void* pData, KISS_UINT Count);
+
 KISS_BOOL KISS_RING_Peek(const KISS_RING* pRB, void* pDest);
 KISS_BOOL KISS_RING_GetPtr(KISS_RING* pRB, void** ppDest);
 /* Must be used with KISS_RING_GetPtr() to "unuse" the Ring Buffer */
 void KISS_RING_Purge(KISS_RING* pRB);
 
+/* Non-consuming access to the element Index positions from the front. Return 0 on success */
+KISS_BOOL KISS_RING_PeekAt(const KISS_RING* pRB, KISS_UINT Index, void* pDest);
+KISS_BOOL KISS_RING_PeekPtrAt(const KISS_RING* pRB, KISS_UINT Index, void** ppDest);
+/* Describe the elements in the ring buffer, front to back, as at most two contiguous spans.
+   Returns the number of spans filled in */
+KISS_UINT KISS_RING_GetSpans(const KISS_RING* pRB, KISS_RING_SPAN pSpans[2]);
+
+#if defined(__unix__) || defined(__APPLE__)
+/* Byte stream helpers for ring buffers with an ItemSize of 1. KISS_RING_PutN()/KISS_RING_GetN()
+   provide the bulk write/read, these move data between the ring buffer and a file descriptor.
+   They return the number of bytes transferred or -1 on error (see errno) */
+int KISS_RING_ReadFd(KISS_RING* pRB, int fd);
+int KISS_RING_WriteFd(KISS_RING* pRB, int fd);
+#endif
+
+/* Get a pointer to up to Count contiguous free slots at the back of the ring buffer.
+   Returns the number of slots reserved */
+KISS_UINT KISS_RING_Reserve(KISS_RING* pRB, void** ppDest, KISS_UINT Count);
+/* Must be used with KISS_RING_Reserve() to publish the first Count reserved slots */
+void KISS_RING_Commit(KISS_RING* pRB, KISS_UINT Count);
+
+/*
+KISS_RING_DEFINE(name, type, capacity) generates a ring buffer type called name holding up to
+capacity elements of type, with the storage embedded in the struct, and a set of static inline
+functions name##_Create/Clear/GetItemCnt/Put/PutFront/Get/Peek/GetPtr/Purge with the same
+semantics as the KISS_RING functions. As the element size and capacity are compile time
+constants each element is moved with a plain assignment instead of a KISS_MEMCPY call.
+*/
+#define KISS_RING_DEFINE(name, type, capacity) \
+typedef struct name { \
+    type Items[capacity]; \
+    KISS_UINT NumUsed; \
+    KISS_UINT oHead; \
+} name; \
+typedef char name##_CapacityCheck[((capacity) > 0) ? 1 : -1]; \
+KISS_INLINE void name##_Create(name* pRB) { \
+    pRB->NumUsed = 0; \
+    pRB->oHead = 0; \
+} \
+KISS_INLINE void name##_Clear(name* pRB) { \
+    pRB->NumUsed = 0; \
+} \
+KISS_INLINE int name##_GetItemCnt(const name* pRB) { \
+    return (int)pRB->NumUsed; \
+} \
+KISS_INLINE KISS_BOOL name##_Put(name* pRB, const type* pElement) { \
+    if (pRB->NumUsed < (capacity)) { \
+        pRB->Items[(pRB->oHead + pRB->NumUsed) % (capacity)] = *pElement; \
+        pRB->NumUsed++; \
+        return 0; \
+    } \
+    return 1; \
+} \
+KISS_INLINE KISS_BOOL name##_PutFront(name* pRB, const type* pElement) { \
+    if (pRB->NumUsed < (capacity)) { \
+        pRB->oHead = (pRB->oHead + (capacity) - 1) % (capacity); \
+        pRB->Items[pRB->oHead] = *pElement; \
+        pRB->NumUsed++; \
+        return 0; \
+    } \
+    return 1; \
+} \
+KISS_INLINE KISS_BOOL name##_Get(name* pRB, type* pData) { \
+    if (pRB->NumUsed > 0 && pData != NULL) { \
+        *pData = pRB->Items[pRB->oHead]; \
+        pRB->oHead = (pRB->oHead + 1) % (capacity); \
+        pRB->NumUsed--; \
+        return 0; \
+    } \
+    return 1; \
+} \
+KISS_INLINE KISS_BOOL name##_Peek(const name* pRB, type* pDest) { \
+    if (pRB->NumUsed > 0 && pDest != NULL) { \
+        *pDest = pRB->Items[pRB->oHead]; \
+        return 0; \
+    } \
+    return 1; \
+} \
+KISS_INLINE KISS_BOOL name##_GetPtr(name* pRB, type** ppDest) { \
+    if (pRB->NumUsed > 0 && ppDest != NULL) { \
+        *ppDest = &pRB->Items[pRB->oHead]; \
+        return 0; \
+    } \
+    return 1; \
+} \
+KISS_INLINE void name##_Purge(name* pRB) { \
+    if (pRB->NumUsed > 0) { \
+        pRB->oHead = (pRB->oHead + 1) % (capacity); \
+        pRB->NumUsed--; \
+    } \
+}
+
 #ifdef __cplusplus
 }
 #endif
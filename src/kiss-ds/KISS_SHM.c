@@ -0,0 +1,262 @@
+/*================================================================================
+*   zlib/libpng license
+*
+*   Copyright (c) 2021. Denis Hilliard
+*
+*   This software is provided 'as-is', without any express or implied warranty.
+*    In no event will the authors be held liable for any damages arising from the
+*    use of this software.
+*
+*    Permission is granted to anyone to use this software for any purpose,
+*    including commercial applications, and to alter it and redistribute it
+*    freely, subject to the following restrictions:
+*
+*        1. The origin of this software must not be misrepresented; you must not
+*        claim that you wrote the original software. If you use this software in a
+*        product, an acknowledgment in the product documentation would be
+*        appreciated but is not required.
+*
+*        2. Altered source versions must be plainly marked as such, and must not
+*        be misrepresented as being the original software.
+*
+*        3. This notice may not be removed or altered from any source
+*        distribution.
+*
+*   Component: Shared Memory Segments
+*   File: KISS_SHM.c
+*   Description:  This file implements helpers to place the concurrent single
+*                 producer/single consumer data structures in named shared memory
+*                 so they can be used between processes.
+*   Caution/Notes:  Requires POSIX shm_open().
+*=================================================================================*/
+#include "KISS_SHM.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/* Identifies a segment created by KISS_SHM ("KSHM") */
+#define KISS_SHM_MAGIC 0x4D48534B
+/* Types of object held by a segment */
+#define KISS_SHM_TYPE_SPSCRING 1
+#define KISS_SHM_TYPE_SPSCQUEUE 2
+
+/* Layout of the start of the segment. The object follows at ObjectOffset */
+typedef struct {
+    KISS_UINT Magic; /* Written last by the creator */
+    KISS_UINT Type;
+    KISS_UINT HeaderSize;
+    KISS_UINT ObjectOffset;
+} KISS_SHM_HEADER;
+
+/* Offset of the object, and of its storage which follows it, from the start of the segment */
+#define KISS_SHM_OBJECT_OFFSET KISS_ALIGN_UP(sizeof(KISS_SHM_HEADER), KISS_CACHELINE_SIZE)
+#define KISS_SHM_DATA_OFFSET(objsize) KISS_ALIGN_UP(KISS_SHM_OBJECT_OFFSET + (objsize), KISS_CACHELINE_SIZE)
+
+/* Internal function to create and map a segment of Size bytes. Returns a pointer to the object or NULL */
+static void* __create(KISS_SHM* pShm, const char* pName, KISS_UINT Size);
+/* Internal function to map an existing segment holding an object of the given Type. Returns a pointer to the object or NULL */
+static void* __attach(KISS_SHM* pShm, const char* pName, KISS_UINT Type);
+/* Internal function to publish a fully initialised segment to attaching processes */
+static void __publish(KISS_SHM* pShm, KISS_UINT Type);
+
+/* ===============================================================================
+* Name: KISS_SHM_CreateSPSCRing()
+* Description: Create a shared memory segment holding a single producer/single
+*              consumer ring buffer and its storage.
+* Parameters:   [O] pShm - Pointer to the segment
+*               [I] pName - Name of the segment, e.g. "/my-ring"
+*               [I] sizeofMsg - Size of each individual message
+*               [I] maxnofmsg - Number of messages in the ring buffer
+*               [O] ppRB - Pointer to receive the ring buffer
+* Return: int - Returns 0 on success, non-zero if the segment exists already or
+*               can't be created.
+* Caution/Notes: Always fails on platforms without POSIX shared memory.
+================================================================================== */
+int KISS_SHM_CreateSPSCRing(KISS_SHM* pShm, const char* pName, KISS_UINT16 sizeofMsg, KISS_UINT maxnofmsg, KISS_SPSCRING** ppRB) {
+    KISS_ASSERT(ppRB != NULL, "Ring Buffer must be a valid pointer");
+    const KISS_UINT DataOffset = KISS_SHM_DATA_OFFSET(sizeof(KISS_SPSCRING));
+    KISS_SPSCRING* pRB = (KISS_SPSCRING*)__create(pShm, pName, DataOffset + (KISS_UINT)sizeofMsg * maxnofmsg);
+    if (pRB != NULL) {
+        KISS_SPSCRING_Create(pRB, sizeofMsg, maxnofmsg, (uint8_t*)pShm->pBase + DataOffset);
+        __publish(pShm, KISS_SHM_TYPE_SPSCRING);
+        *ppRB = pRB;
+        return 0;
+    }
+    return 1;
+}
+
+/* ===============================================================================
+* Name: KISS_SHM_AttachSPSCRing()
+* Description: Map an existing shared memory segment holding a ring buffer.
+* Parameters:   [O] pShm - Pointer to the segment
+*               [I] pName - Name of the segment
+*               [O] ppRB - Pointer to receive the ring buffer
+* Return: int - Returns 0 on success, non-zero if the segment doesn't exist, is
+*               not initialised yet, or doesn't hold a ring buffer.
+* Caution/Notes: Always fails on platforms without POSIX shared memory.
+================================================================================== */
+int KISS_SHM_AttachSPSCRing(KISS_SHM* pShm, const char* pName, KISS_SPSCRING** ppRB) {
+    KISS_ASSERT(ppRB != NULL, "Ring Buffer must be a valid pointer");
+    KISS_SPSCRING* pRB = (KISS_SPSCRING*)__attach(pShm, pName, KISS_SHM_TYPE_SPSCRING);
+    if (pRB != NULL) {
+        *ppRB = pRB;
+        return 0;
+    }
+    return 1;
+}
+
+/* ===============================================================================
+* Name: KISS_SHM_CreateSPSCQueue()
+* Description: Create a shared memory segment holding a single producer/single
+*              consumer queue and its storage.
+* Parameters:   [O] pShm - Pointer to the segment
+*               [I] pName - Name of the segment, e.g. "/my-queue"
+*               [I] Size - Size (in bytes) of the queue storage
+*               [O] ppQ - Pointer to receive the queue
+* Return: int - Returns 0 on success, non-zero if the segment exists already or
+*               can't be created.
+* Caution/Notes: Always fails on platforms without POSIX shared memory.
+================================================================================== */
+int KISS_SHM_CreateSPSCQueue(KISS_SHM* pShm, const char* pName, KISS_UINT Size, KISS_SPSCQUEUE** ppQ) {
+    KISS_ASSERT(ppQ != NULL, "Queue must be a valid pointer");
+    const KISS_UINT DataOffset = KISS_SHM_DATA_OFFSET(sizeof(KISS_SPSCQUEUE));
+    KISS_SPSCQUEUE* pQ = (KISS_SPSCQUEUE*)__create(pShm, pName, DataOffset + Size);
+    if (pQ != NULL) {
+        KISS_SPSCQUEUE_Create(pQ, (uint8_t*)pShm->pBase + DataOffset, Size);
+        __publish(pShm, KISS_SHM_TYPE_SPSCQUEUE);
+        *ppQ = pQ;
+        return 0;
+    }
+    return 1;
+}
+
+/* ===============================================================================
+* Name: KISS_SHM_AttachSPSCQueue()
+* Description: Map an existing shared memory segment holding a queue.
+* Parameters:   [O] pShm - Pointer to the segment
+*               [I] pName - Name of the segment
+*               [O] ppQ - Pointer to receive the queue
+* Return: int - Returns 0 on success, non-zero if the segment doesn't exist, is
+*               not initialised yet, or doesn't hold a queue.
+* Caution/Notes: Always fails on platforms without POSIX shared memory.
+================================================================================== */
+int KISS_SHM_AttachSPSCQueue(KISS_SHM* pShm, const char* pName, KISS_SPSCQUEUE** ppQ) {
+    KISS_ASSERT(ppQ != NULL, "Queue must be a valid pointer");
+    KISS_SPSCQUEUE* pQ = (KISS_SPSCQUEUE*)__attach(pShm, pName, KISS_SHM_TYPE_SPSCQUEUE);
+    if (pQ != NULL) {
+        *ppQ = pQ;
+        return 0;
+    }
+    return 1;
+}
+
+/* ===============================================================================
+* Name: KISS_SHM_Detach()
+* Description: Unmap the segment from this process.
+* Parameters: [I/O] pShm - Pointer to the segment
+* Return: None
+* Caution/Notes: The object must no longer be used by this process.
+================================================================================== */
+void KISS_SHM_Detach(KISS_SHM* pShm) {
+    KISS_ASSERT(pShm != NULL, "Segment must be a valid pointer");
+#if defined(__unix__) || defined(__APPLE__)
+    if (pShm->pBase != NULL) {
+        munmap(pShm->pBase, pShm->Size);
+    }
+#endif
+    pShm->pBase = NULL;
+    pShm->Size = 0;
+}
+
+/* ===============================================================================
+* Name: KISS_SHM_Unlink()
+* Description: Remove the name of a segment. The memory is released once every
+*              process has detached.
+* Parameters: [I] pName - Name of the segment
+* Return: int - Returns 0 on success
+* Caution/Notes: None
+================================================================================== */
+int KISS_SHM_Unlink(const char* pName) {
+    KISS_ASSERT(pName != NULL, "Name must be a valid pointer");
+#if defined(__unix__) || defined(__APPLE__)
+    return (shm_unlink(pName) == 0) ? 0 : 1;
+#else
+    return 1;
+#endif
+}
+
+static void* __create(KISS_SHM* pShm, const char* pName, KISS_UINT Size) {
+    KISS_ASSERT(pShm != NULL, "Segment must be a valid pointer");
+    KISS_ASSERT(pName != NULL, "Name must be a valid pointer");
+    pShm->pBase = NULL;
+    pShm->Size = 0;
+#if defined(__unix__) || defined(__APPLE__)
+    int fd = shm_open(pName, O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd < 0) {
+        return NULL;
+    }
+    void* pBase = MAP_FAILED;
+    if (ftruncate(fd, (off_t)Size) == 0) {
+        pBase = mmap(NULL, Size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    /* The mapping keeps the segment alive */
+    close(fd);
+    if (pBase == MAP_FAILED) {
+        shm_unlink(pName);
+        return NULL;
+    }
+    pShm->pBase = pBase;
+    pShm->Size = Size;
+    return (uint8_t*)pBase + KISS_SHM_OBJECT_OFFSET;
+#else
+    (void)Size;
+    return NULL;
+#endif
+}
+
+static void* __attach(KISS_SHM* pShm, const char* pName, KISS_UINT Type) {
+    KISS_ASSERT(pShm != NULL, "Segment must be a valid pointer");
+    KISS_ASSERT(pName != NULL, "Name must be a valid pointer");
+    pShm->pBase = NULL;
+    pShm->Size = 0;
+#if defined(__unix__) || defined(__APPLE__)
+    struct stat st;
+    int fd = shm_open(pName, O_RDWR, 0600);
+    if (fd < 0) {
+        return NULL;
+    }
+    void* pBase = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && (size_t)st.st_size >= KISS_SHM_OBJECT_OFFSET) {
+        pBase = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (pBase == MAP_FAILED) {
+        return NULL;
+    }
+    KISS_SHM_HEADER* pHdr = (KISS_SHM_HEADER*)pBase;
+    /* The magic is only set once the creator has initialised the object */
+    if (KISS_ATOMIC_LOAD(&pHdr->Magic) != KISS_SHM_MAGIC || pHdr->Type != Type ||
+        pHdr->HeaderSize != sizeof(KISS_SHM_HEADER) || pHdr->ObjectOffset != KISS_SHM_OBJECT_OFFSET) {
+        munmap(pBase, (size_t)st.st_size);
+        return NULL;
+    }
+    pShm->pBase = pBase;
+    pShm->Size = (KISS_UINT)st.st_size;
+    return (uint8_t*)pBase + KISS_SHM_OBJECT_OFFSET;
+#else
+    (void)Type;
+    return NULL;
+#endif
+}
+
+static void __publish(KISS_SHM* pShm, KISS_UINT Type) {
+    KISS_SHM_HEADER* pHdr = (KISS_SHM_HEADER*)pShm->pBase;
+    pHdr->Type = Type;
+    pHdr->HeaderSize = sizeof(KISS_SHM_HEADER);
+    pHdr->ObjectOffset = KISS_SHM_OBJECT_OFFSET;
+    KISS_ATOMIC_STORE(&pHdr->Magic, KISS_SHM_MAGIC);
+}
@@ -0,0 +1,75 @@
+/*================================================================================
+*   zlib/libpng license
+*
+*   Copyright (c) 2021. Denis Hilliard
+*
+*   This software is provided 'as-is', without any express or implied warranty.
+*    In no event will the authors be held liable for any damages arising from the
+*    use of this software.
+*
+*    Permission is granted to anyone to use this software for any purpose,
+*    including commercial applications, and to alter it and redistribute it
+*    freely, subject to the following restrictions:
+*
+*        1. The origin of this software must not be misrepresented; you must not
+*        claim that you wrote the original software. If you use this software in a
+*        product, an acknowledgment in the product documentation would be
+*        appreciated but is not required.
+*
+*        2. Altered source versions must be plainly marked as such, and must not
+*        be misrepresented as being the original software.
+*
+*        3. This notice may not be removed or altered from any source
+*        distribution.
+*
+*   Component: Shared Memory Segments
+*   File: KISS_SHM.h
+*   Description:  This file implements helpers to place the concurrent single
+*                 producer/single consumer data structures in named shared memory
+*                 so they can be used between processes.
+*   Caution/Notes:  Requires POSIX shm_open().
+*=================================================================================*/
+#ifndef _KISS_SHM_H_
+#define _KISS_SHM_H_
+
+#include "KISS_Common.h"
+#include "KISS_SPSCRING.h"
+#include "KISS_SPSCQUEUE.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+KISS_SHM maps a named shared memory segment holding a small header, a KISS_SPSCRING or
+KISS_SPSCQUEUE object and its storage. These objects address their storage relative to
+themselves and only hold offsets, so every process can map the segment at a different
+address. One process creates the segment, the other attaches to it by name, and from then on
+messages are exchanged without any system call on the data path. The objects are created
+without the blocking flags, so the consumer polls rather than calling GetWait().
+The non-concurrent KISS_RING and KISS_QUEUE can't be shared this way as they would need a lock
+around every call; KISS_SPSCRING and KISS_SPSCQUEUE are their concurrent counterparts.
+Both processes must be built for the same ABI.
+*/
+typedef struct {
+    void* pBase;
+    KISS_UINT Size;
+} KISS_SHM;
+
+/* Create the segment pName holding a ring buffer of maxnofmsg messages of sizeofMsg bytes. Returns 0 on success */
+int KISS_SHM_CreateSPSCRing(KISS_SHM* pShm, const char* pName, KISS_UINT16 sizeofMsg, KISS_UINT maxnofmsg, KISS_SPSCRING** ppRB);
+/* Attach to the ring buffer in the segment pName. Returns 0 on success */
+int KISS_SHM_AttachSPSCRing(KISS_SHM* pShm, const char* pName, KISS_SPSCRING** ppRB);
+/* Create the segment pName holding a queue with Size bytes of storage. Returns 0 on success */
+int KISS_SHM_CreateSPSCQueue(KISS_SHM* pShm, const char* pName, KISS_UINT Size, KISS_SPSCQUEUE** ppQ);
+/* Attach to the queue in the segment pName. Returns 0 on success */
+int KISS_SHM_AttachSPSCQueue(KISS_SHM* pShm, const char* pName, KISS_SPSCQUEUE** ppQ);
+/* Unmap the segment. The segment itself remains until it is unlinked */
+void KISS_SHM_Detach(KISS_SHM* pShm);
+/* Remove the name of the segment. Returns 0 on success */
+int KISS_SHM_Unlink(const char* pName);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
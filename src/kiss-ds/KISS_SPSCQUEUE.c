@@ -0,0 +1,341 @@
+/*================================================================================
+*   zlib/libpng license
+*
+*   Copyright (c) 2021. Denis Hilliard
+*
+*   This software is provided 'as-is', without any express or implied warranty.
+*    In no event will the authors be held liable for any damages arising from the
+*    use of this software.
+*
+*    Permission is granted to anyone to use this software for any purpose,
+*    including commercial applications, and to alter it and redistribute it
+*    freely, subject to the following restrictions:
+*
+*        1. The origin of this software must not be misrepresented; you must not
+*        claim that you wrote the original software. If you use this software in a
+*        product, an acknowledgment in the product documentation would be
+*        appreciated but is not required.
+*
+*        2. Altered source versions must be plainly marked as such, and must not
+*        be misrepresented as being the original software.
+*
+*        3. This notice may not be removed or altered from any source
+*        distribution.
+*
+*   Component: Single Producer/Single Consumer Queue
+*   File: KISS_SPSCQUEUE.c
+*   Description:  This file implements the logic for a lock-free queue of variable
+*                 size elements shared between one producer and one consumer thread.
+*   Caution/Notes:  None
+*=================================================================================*/
+#include "KISS_SPSCQUEUE.h"
+#include "KISS_WAIT.h"
+
+typedef struct {
+    KISS_UINT oNext;
+    KISS_UINT oSize;
+} KISS_SPSCQUEUE_ITEM;
+
+/* oSize of the marker record telling the consumer to continue at the start of the buffer */
+#define KISS_SPSCQUEUE_WRAP 0xFFFFFFFF
+
+/* Internal function to get the address of the storage */
+static uint8_t* __buffer(const KISS_SPSCQUEUE* pQ);
+/* Internal function to find room for a record of Need bytes given the consumer offset oHead */
+static KISS_BOOL __find_space(const KISS_SPSCQUEUE* pQ, KISS_UINT oHead, KISS_UINT Need, KISS_UINT* poRecord);
+/* Internal function shared between KISS_SPSCQUEUE_Put and KISS_SPSCQUEUE_PutEx to allocate a new queue item within the buffer */
+static void* __alloc_item(KISS_SPSCQUEUE* pQ, KISS_UINT Size);
+/* Internal function to publish the item allocated by __alloc_item() to the consumer */
+static void __commit_item(KISS_SPSCQUEUE* pQ, void* pDest);
+
+/* ===============================================================================
+* Name: KISS_SPSCQUEUE_Create()
+* Description: Initialise the queue with a fixed size / preallocated memory buffer
+* Parameters:   [O] pQ - Pointer to the queue to initialise
+*               [I] pData - Pointer to buffer to use for queue storage
+*               [I] Size - Size of the buffer in bytes.
+* Return: None
+* Caution/Notes: pData must be aligned to KISS_SPSCQUEUE_ALIGN. Size is rounded down
+*                to a multiple of KISS_SPSCQUEUE_ALIGN. The queue must be created
+*                before either thread uses it.
+================================================================================== */
+void KISS_SPSCQUEUE_Create(KISS_SPSCQUEUE* pQ, void* pData, KISS_UINT Size) {
+    KISS_SPSCQUEUE_CreateEx(pQ, pData, Size, 0);
+}
+
+/* ===============================================================================
+* Name: KISS_SPSCQUEUE_CreateEx()
+* Description: Initialise the queue with a fixed size / preallocated memory buffer
+*              and additional options.
+* Parameters:   [O] pQ - Pointer to the queue to initialise
+*               [I] pData - Pointer to buffer to use for queue storage
+*               [I] Size - Size of the buffer in bytes.
+*               [I] Flags - Combination of KISS_SPSCQUEUE_FLAG_* options
+* Return: None
+* Caution/Notes: pData must be aligned to KISS_SPSCQUEUE_ALIGN. Size is rounded down
+*                to a multiple of KISS_SPSCQUEUE_ALIGN. The queue must be created
+*                before either thread uses it.
+================================================================================== */
+void KISS_SPSCQUEUE_CreateEx(KISS_SPSCQUEUE* pQ, void* pData, KISS_UINT Size, KISS_UINT16 Flags) {
+    KISS_ASSERT(pQ != NULL, "Queue must be a valid pointer");
+    KISS_ASSERT(pData != NULL, "Storage buffer must not be NULL");
+    KISS_ASSERT(((uintptr_t)pData % KISS_SPSCQUEUE_ALIGN) == 0, "Storage buffer is not aligned");
+    KISS_MEMSET(pQ, 0, sizeof(KISS_SPSCQUEUE));
+    pQ->oBuffer = (intptr_t)pData - (intptr_t)pQ;
+    pQ->TotalSize = KISS_ALIGN_DOWN(Size, KISS_SPSCQUEUE_ALIGN);
+    pQ->Flags = Flags;
+    pQ->oHead = 0;
+    pQ->oTail = 0;
+    pQ->oHeadCache = 0;
+    pQ->oTailCache = 0;
+    pQ->NumPut = 0;
+    pQ->NumGot = 0;
+    pQ->SpinLimit = KISS_WAIT_SPIN_MIN;
+    pQ->NumWaiters = 0;
+    pQ->WaitSeq = 0;
+}
+
+/* ===============================================================================
+* Name: KISS_SPSCQUEUE_Delete()
+* Description: Deallocate the queue
+* Parameters:   [O] pQ - Pointer to the queue to deallocate
+* Return: None
+* Caution/Notes: No thread may use the queue during or after this call.
+================================================================================== */
+void KISS_SPSCQUEUE_Delete(KISS_SPSCQUEUE* pQ) {
+    KISS_ASSERT(pQ != NULL, "Queue must be a valid pointer");
+    KISS_MEMSET(pQ, 0, sizeof(KISS_SPSCQUEUE));
+}
+
+/* ===============================================================================
+* Name: KISS_SPSCQUEUE_Put()
+* Description: Put an item to the end of the queue.
+* Parameters: [I/O] pQ - Pointer to the queue to modify
+*               [I] pSrc - Pointer to data to add to queue
+*               [I] Size - Size of data to add to queue
+* Return: int - Returns 0 on success, non-zero if the queue has no room for the item.
+* Caution/Notes: Must only be called from the producer thread.
+================================================================================== */
+int KISS_SPSCQUEUE_Put(KISS_SPSCQUEUE* pQ, const void* pSrc, KISS_UINT Size) {
+    KISS_ASSERT(pQ != NULL, "Queue must be a valid pointer");
+    void* pDest = __alloc_item(pQ, Size);
+    if (pDest != NULL) {
+        KISS_MEMCPY(pDest, pSrc, Size);
+        __commit_item(pQ, pDest);
+        return 0;
+    }
+    return 1;
+}
+
+/* ===============================================================================
+* Name: KISS_SPSCQUEUE_PutEx()
+* Description:  Put an item to the end of the queue, assembling it in place from
+*               each source component.
+* Parameters:   [I/O] pQ - Pointer to the queue to modify
+*               [I] pSrcList - Array of source components to build the queue data from.
+*               [I] NumSrc - Number of elements in the source array.
+* Return: int - Returns 0 on success.
+* Caution/Notes: Must only be called from the producer thread.
+================================================================================== */
+int KISS_SPSCQUEUE_PutEx(KISS_SPSCQUEUE* pQ, const KISS_QUEUE_SRCLIST* pSrcList, KISS_UINT NumSrc) {
+    KISS_ASSERT(pQ != NULL, "Queue must be a valid pointer");
+    if (pSrcList != NULL) {
+        KISS_UINT Size = 0;
+        for (KISS_UINT i = 0; i < NumSrc; ++i) {
+            Size += pSrcList[i].Size;
+        }
+        uint8_t* pDest = (uint8_t*)__alloc_item(pQ, Size);
+        if (pDest != NULL) {
+            uint8_t* pNext = pDest;
+            for (KISS_UINT i = 0; i < NumSrc; ++i) {
+                KISS_MEMCPY(pNext, pSrcList[i].pSrc, pSrcList[i].Size);
+                pNext += pSrcList[i].Size;
+            }
+            __commit_item(pQ, pDest);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/* ===============================================================================
+* Name: KISS_SPSCQUEUE_GetPtr()
+* Description: Get the pointer to first element stored in the queue
+* Parameters:   [I/O] pQ - Pointer to the queue to retrieve data from.
+*               [O] ppData - Pointer to pointer to receive the first element.
+*               [O] pSize - Optional pointer to receive the size of the element.
+* Return: int - Returns 0 on success, non-zero if the queue is empty.
+* Caution/Notes: Must only be called from the consumer thread. The element remains
+*                owned by the consumer until KISS_SPSCQUEUE_Purge() is called.
+================================================================================== */
+int KISS_SPSCQUEUE_GetPtr(KISS_SPSCQUEUE* pQ, void** ppData, KISS_UINT* pSize) {
+    KISS_ASSERT(pQ != NULL, "Queue must be a valid pointer");
+    KISS_UINT oHead = KISS_ATOMIC_LOAD_RELAXED(&pQ->oHead);
+
+    if (ppData != NULL) {
+        if (oHead == pQ->oTailCache) {
+            /* Looks empty: refresh the cached tail from the producer's cache line */
+            pQ->oTailCache = KISS_ATOMIC_LOAD(&pQ->oTail);
+            if (oHead == pQ->oTailCache) {
+                return 1;
+            }
+        }
+        const KISS_SPSCQUEUE_ITEM* pItem = (const KISS_SPSCQUEUE_ITEM*)&__buffer(pQ)[oHead];
+        if (pItem->oSize == KISS_SPSCQUEUE_WRAP) {
+            /* The producer skipped the end of the buffer, the record is at the start.
+               The marker was published together with that record so it is never empty */
+            oHead = 0;
+            KISS_ATOMIC_STORE(&pQ->oHead, oHead);
+            pItem = (const KISS_SPSCQUEUE_ITEM*)__buffer(pQ);
+        }
+        *ppData = (uint8_t*)pItem + sizeof(KISS_SPSCQUEUE_ITEM);
+        if (pSize != NULL) {
+            *pSize = pItem->oSize;
+        }
+        return 0;
+    }
+    return 1;
+}
+
+/* ===============================================================================
+* Name: KISS_SPSCQUEUE_GetWait()
+* Description: Get the pointer to first element stored in the queue, waiting for one
+*              to arrive if the queue is empty.
+* Parameters:   [I/O] pQ - Pointer to the queue to retrieve data from.
+*               [O] ppData - Pointer to pointer to receive the first element.
+*               [O] pSize - Optional pointer to receive the size of the element.
+*               [I] TimeoutMs - Maximum time to block in milliseconds. Negative waits forever.
+* Return: int - Returns 0 on success, non-zero on timeout
+* Caution/Notes: Must only be called from the consumer thread of a queue created with
+*                KISS_SPSCQUEUE_FLAG_BLOCKING. Polls, then blocks as KISS_SPSCRING_GetWait()
+*                does. The element must be released with KISS_SPSCQUEUE_Purge().
+================================================================================== */
+int KISS_SPSCQUEUE_GetWait(KISS_SPSCQUEUE* pQ, void** ppData, KISS_UINT* pSize, KISS_INT TimeoutMs) {
+    KISS_ASSERT(pQ != NULL, "Queue must be a valid pointer");
+    KISS_ASSERT(pQ->Flags & KISS_SPSCQUEUE_FLAG_BLOCKING, "The queue must be created with KISS_SPSCQUEUE_FLAG_BLOCKING");
+    const uint64_t Deadline = KISS_WAIT_GetTimeMs() + (uint64_t)KISS_MAX(TimeoutMs, 0);
+
+    for (KISS_UINT i = 0; i < pQ->SpinLimit; ++i) {
+        if (KISS_SPSCQUEUE_GetPtr(pQ, ppData, pSize) == 0) {
+            pQ->SpinLimit = KISS_MIN(pQ->SpinLimit * 2, KISS_WAIT_SPIN_MAX);
+            return 0;
+        }
+        KISS_WAIT_Pause();
+    }
+    pQ->SpinLimit = KISS_MAX(pQ->SpinLimit / 2, KISS_WAIT_SPIN_MIN);
+
+    for (;;) {
+        const KISS_UINT Seq = KISS_ATOMIC_LOAD(&pQ->WaitSeq);
+        /* Register as a waiter before the final check so a concurrent Put either
+           sees the waiter or its record is seen by the check */
+        KISS_ATOMIC_FETCH_ADD(&pQ->NumWaiters, 1);
+        if (KISS_SPSCQUEUE_GetPtr(pQ, ppData, pSize) == 0) {
+            KISS_ATOMIC_FETCH_ADD(&pQ->NumWaiters, (KISS_UINT)-1);
+            return 0;
+        }
+        const KISS_INT RemainingMs = KISS_WAIT_RemainingMs(Deadline, TimeoutMs);
+        const int TimedOut = (RemainingMs == 0) || KISS_WAIT_Wait(&pQ->WaitSeq, Seq, RemainingMs);
+        KISS_ATOMIC_FETCH_ADD(&pQ->NumWaiters, (KISS_UINT)-1);
+        if (TimedOut) {
+            return KISS_SPSCQUEUE_GetPtr(pQ, ppData, pSize);
+        }
+    }
+}
+
+/* ===============================================================================
+* Name: KISS_SPSCQUEUE_Purge()
+* Description: Remove the top most element from the queue, releasing its space to the producer.
+* Parameters: [I/O] pQ - Pointer to the queue to modify
+* Return: None
+* Caution/Notes: Must only be called from the consumer thread after a successful
+*                call to KISS_SPSCQUEUE_GetPtr().
+================================================================================== */
+void KISS_SPSCQUEUE_Purge(KISS_SPSCQUEUE* pQ) {
+    KISS_ASSERT(pQ != NULL, "Queue must be a valid pointer");
+    const KISS_UINT oHead = KISS_ATOMIC_LOAD_RELAXED(&pQ->oHead);
+    if (oHead != pQ->oTailCache) {
+        const KISS_SPSCQUEUE_ITEM* pItem = (const KISS_SPSCQUEUE_ITEM*)&__buffer(pQ)[oHead];
+        KISS_ASSERT(pItem->oSize != KISS_SPSCQUEUE_WRAP, "KISS_SPSCQUEUE_GetPtr() must be called first");
+        KISS_ATOMIC_STORE(&pQ->NumGot, pQ->NumGot + 1);
+        KISS_ATOMIC_STORE(&pQ->oHead, pItem->oNext);
+    }
+}
+
+/* ===============================================================================
+* Name: KISS_SPSCQUEUE_GetItemCnt()
+* Description: Get the number of elements currently in the queue.
+* Parameters: [I] pQ - Pointer to the queue
+* Return: int - Returns number of elements in the queue
+* Caution/Notes: The result is only a snapshot if the other thread is active.
+================================================================================== */
+int KISS_SPSCQUEUE_GetItemCnt(const KISS_SPSCQUEUE* pQ) {
+    KISS_ASSERT(pQ != NULL, "Queue must be a valid pointer");
+    const KISS_UINT NumGot = KISS_ATOMIC_LOAD(&pQ->NumGot);
+    const KISS_UINT NumPut = KISS_ATOMIC_LOAD(&pQ->NumPut);
+    return (int)(NumPut - NumGot);
+}
+
+static KISS_BOOL __find_space(const KISS_SPSCQUEUE* pQ, KISS_UINT oHead, KISS_UINT Need, KISS_UINT* poRecord) {
+    const KISS_UINT oTail = pQ->oTail;
+    /* oTail never catches up with oHead from behind, as oTail == oHead means empty */
+    if (oTail >= oHead) {
+        if (Need < pQ->TotalSize - oTail || (Need == pQ->TotalSize - oTail && oHead != 0)) {
+            *poRecord = oTail;
+            return 0;
+        }
+        if (Need < oHead) {
+            /* Wrap around: the marker fits as oTail is aligned and below TotalSize */
+            *poRecord = 0;
+            return 0;
+        }
+    }
+    else if (Need < oHead - oTail) {
+        *poRecord = oTail;
+        return 0;
+    }
+    return 1;
+}
+
+static void* __alloc_item(KISS_SPSCQUEUE* pQ, KISS_UINT Size) {
+    const KISS_UINT Need = KISS_ALIGN_UP(sizeof(KISS_SPSCQUEUE_ITEM) + Size, KISS_SPSCQUEUE_ALIGN);
+    KISS_UINT oRecord = 0;
+
+    if (Size > pQ->TotalSize || Need >= pQ->TotalSize) {
+        return NULL;
+    }
+    if (__find_space(pQ, pQ->oHeadCache, Need, &oRecord) != 0) {
+        /* Looks full: refresh the cached head from the consumer's cache line */
+        pQ->oHeadCache = KISS_ATOMIC_LOAD(&pQ->oHead);
+        if (__find_space(pQ, pQ->oHeadCache, Need, &oRecord) != 0) {
+            return NULL;
+        }
+    }
+    if (oRecord != pQ->oTail) {
+        KISS_SPSCQUEUE_ITEM* pMarker = (KISS_SPSCQUEUE_ITEM*)&__buffer(pQ)[pQ->oTail];
+        pMarker->oNext = 0;
+        pMarker->oSize = KISS_SPSCQUEUE_WRAP;
+    }
+    KISS_SPSCQUEUE_ITEM* pItem = (KISS_SPSCQUEUE_ITEM*)&__buffer(pQ)[oRecord];
+    pItem->oSize = Size;
+    pItem->oNext = (oRecord + Need == pQ->TotalSize) ? 0 : oRecord + Need;
+    return (uint8_t*)pItem + sizeof(KISS_SPSCQUEUE_ITEM);
+}
+
+static void __commit_item(KISS_SPSCQUEUE* pQ, void* pDest) {
+    const KISS_SPSCQUEUE_ITEM* pItem = (const KISS_SPSCQUEUE_ITEM*)((uint8_t*)pDest - sizeof(KISS_SPSCQUEUE_ITEM));
+    KISS_ATOMIC_STORE(&pQ->NumPut, pQ->NumPut + 1);
+    /* Publish the record (and any wrap marker) to the consumer */
+    KISS_ATOMIC_STORE(&pQ->oTail, pItem->oNext);
+    if (pQ->Flags & KISS_SPSCQUEUE_FLAG_BLOCKING) {
+        /* Wake the consumer if it is blocked in KISS_SPSCQUEUE_GetWait(), see KISS_SPSCRING_Put() */
+        KISS_ATOMIC_FENCE();
+        if (KISS_ATOMIC_LOAD_RELAXED(&pQ->NumWaiters) != 0) {
+            KISS_ATOMIC_FETCH_ADD(&pQ->WaitSeq, 1);
+            KISS_WAIT_WakeAll(&pQ->WaitSeq);
+        }
+    }
+}
+
+static uint8_t* __buffer(const KISS_SPSCQUEUE* pQ) {
+    return (uint8_t*)pQ + pQ->oBuffer;
+}
@@ -0,0 +1,106 @@
+/*================================================================================
+*   zlib/libpng license
+*
+*   Copyright (c) 2021. Denis Hilliard
+*
+*   This software is provided 'as-is', without any express or implied warranty.
+*    In no event will the authors be held liable for any damages arising from the
+*    use of this software.
+*
+*    Permission is granted to anyone to use this software for any purpose,
+*    including commercial applications, and to alter it and redistribute it
+*    freely, subject to the following restrictions:
+*
+*        1. The origin of this software must not be misrepresented; you must not
+*        claim that you wrote the original software. If you use this software in a
+*        product, an acknowledgment in the product documentation would be
+*        appreciated but is not required.
+*
+*        2. Altered source versions must be plainly marked as such, and must not
+*        be misrepresented as being the original software.
+*
+*        3. This notice may not be removed or altered from any source
+*        distribution.
+*
+*   Component: Single Producer/Single Consumer Queue
+*   File: KISS_SPSCQUEUE.h
+*   Description:  This file implements the logic for a lock-free queue of variable
+*                 size elements shared between one producer and one consumer thread.
+*   Caution/Notes:  None
+*=================================================================================*/
+#ifndef _KISS_SPSCQUEUE_H_
+#define _KISS_SPSCQUEUE_H_
+
+#include "KISS_Common.h"
+#include "KISS_QUEUE.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Alignment of every record (header + data) in the buffer */
+#define KISS_SPSCQUEUE_ALIGN 8
+
+/*
+KISS_SPSCQUEUE is the concurrent counterpart of KISS_QUEUE for exactly one producer thread and
+one consumer thread. Records use the same {oNext, oSize} header as KISS_QUEUE and are always
+stored contiguously: when a record does not fit before the end of the buffer the producer writes
+a wrap marker and places the record at the start of the buffer instead (BipBuffer style).
+The producer publishes oTail with release semantics after the record is written, and the consumer
+publishes oHead with release semantics once the record is purged. Each side keeps a cached copy
+of the other side's offset so the shared cache line is only read when the queue appears full/empty.
+With KISS_SPSCQUEUE_FLAG_BLOCKING the consumer can block in KISS_SPSCQUEUE_GetWait(), using the
+same waiter registration as KISS_SPSCRING.
+*/
+typedef struct {
+    /* Read-only after creation. The storage is addressed relative to the queue
+       object so both can be placed in shared memory, see KISS_SHM */
+    intptr_t oBuffer;
+    KISS_UINT TotalSize;
+    KISS_UINT16 Flags;
+    uint8_t Pad0[KISS_CACHELINE_SIZE];
+    /* Written by the producer only */
+    KISS_UINT oTail;
+    KISS_UINT oHeadCache;
+    KISS_UINT NumPut;
+    uint8_t Pad1[KISS_CACHELINE_SIZE - 3 * sizeof(KISS_UINT)];
+    /* Written by the consumer only */
+    KISS_UINT oHead;
+    KISS_UINT oTailCache;
+    KISS_UINT NumGot;
+    KISS_UINT SpinLimit;
+    uint8_t Pad2[KISS_CACHELINE_SIZE - 4 * sizeof(KISS_UINT)];
+    /* Blocking consumer support */
+    KISS_UINT NumWaiters;
+    KISS_UINT WaitSeq;
+    uint8_t Pad3[KISS_CACHELINE_SIZE - 2 * sizeof(KISS_UINT)];
+} KISS_SPSCQUEUE;
+
+/* Flags for KISS_SPSCQUEUE_CreateEx() */
+/* The consumer may block in KISS_SPSCQUEUE_GetWait(), Put/PutEx wake it */
+#define KISS_SPSCQUEUE_FLAG_BLOCKING 0x0001
+
+/* Size = Size in bytes of the data buffer, pData must be aligned to KISS_SPSCQUEUE_ALIGN */
+void KISS_SPSCQUEUE_Create(KISS_SPSCQUEUE* pQ, void* pData, KISS_UINT Size);
+/* Create a queue with the specified KISS_SPSCQUEUE_FLAG_* options */
+void KISS_SPSCQUEUE_CreateEx(KISS_SPSCQUEUE* pQ, void* pData, KISS_UINT Size, KISS_UINT16 Flags);
+void KISS_SPSCQUEUE_Delete(KISS_SPSCQUEUE* pQ);
+/* Get the number of items currently in the queue. Only a snapshot when called concurrently. */
+int KISS_SPSCQUEUE_GetItemCnt(const KISS_SPSCQUEUE* pQ);
+
+/* Producer side. These functions return 0 on success */
+int KISS_SPSCQUEUE_Put(KISS_SPSCQUEUE* pQ, const void* pSrc, KISS_UINT Size);
+int KISS_SPSCQUEUE_PutEx(KISS_SPSCQUEUE* pQ, const KISS_QUEUE_SRCLIST* pSrcList, KISS_UINT NumSrc);
+
+/* Consumer side. Returns 0 on success */
+int KISS_SPSCQUEUE_GetPtr(KISS_SPSCQUEUE* pQ, void** ppData, KISS_UINT* pSize);
+/* Spin for a bounded time, then block for up to TimeoutMs milliseconds (negative waits forever) until an element arrives.
+   Requires KISS_SPSCQUEUE_FLAG_BLOCKING */
+int KISS_SPSCQUEUE_GetWait(KISS_SPSCQUEUE* pQ, void** ppData, KISS_UINT* pSize, KISS_INT TimeoutMs);
+/* Must be used with KISS_SPSCQUEUE_GetPtr() to release the element to the producer */
+void KISS_SPSCQUEUE_Purge(KISS_SPSCQUEUE* pQ);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
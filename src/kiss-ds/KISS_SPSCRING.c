@@ -0,0 +1,285 @@
+/*================================================================================
+*   zlib/libpng license
+*
+*   Copyright (c) 2021. Denis Hilliard
+*
+*   This software is provided 'as-is', without any express or implied warranty.
+*    In no event will the authors be held liable for any damages arising from the
+*    use of this software.
+*
+*    Permission is granted to anyone to use this software for any purpose,
+*    including commercial applications, and to alter it and redistribute it
+*    freely, subject to the following restrictions:
+*
+*        1. The origin of this software must not be misrepresented; you must not
+*        claim that you wrote the original software. If you use this software in a
+*        product, an acknowledgment in the product documentation would be
+*        appreciated but is not required.
+*
+*        2. Altered source versions must be plainly marked as such, and must not
+*        be misrepresented as being the original software.
+*
+*        3. This notice may not be removed or altered from any source
+*        distribution.
+*
+*   Component: Single Producer/Single Consumer Ring Buffer
+*   File: KISS_SPSCRING.c
+*   Description:  This file implements the logic for a lock-free fixed size ring
+*                 buffer shared between one producer and one consumer thread.
+*   Caution/Notes:  None
+*=================================================================================*/
+#include "KISS_SPSCRING.h"
+#include "KISS_WAIT.h"
+
+/* Internal helpers to advance an index, map an index to a slot and count the items between two indices */
+static KISS_UINT __next_index(const KISS_SPSCRING* pRB, KISS_UINT o);
+static KISS_UINT __index_to_slot(const KISS_SPSCRING* pRB, KISS_UINT o);
+/* Internal function to get the address of the storage */
+static uint8_t* __buffer(const KISS_SPSCRING* pRB);
+static KISS_UINT __item_count(const KISS_SPSCRING* pRB, KISS_UINT oHead, KISS_UINT oTail);
+
+/* ===============================================================================
+* Name: KISS_SPSCRING_Create()
+* Description: Create a single producer/single consumer ring buffer of fixed size items.
+* Parameters:   [O] pRB - Pointer to ring buffer
+*               [I] sizeofMsg - Size of each individual message
+*               [I] maxnofmsg - Number of messages in the buffer
+*               [I] pBuffer - Pointer to buffer to use for storage
+* Return: None
+* Caution/Notes: Memory pointed to by pBuffer must be at least sizeofMsg * maxnofmsg bytes.
+*                The ring buffer must be created before either thread uses it.
+================================================================================== */
+void KISS_SPSCRING_Create(KISS_SPSCRING* pRB, KISS_UINT16 sizeofMsg, KISS_UINT maxnofmsg, void* pBuffer) {
+    KISS_SPSCRING_CreateEx(pRB, sizeofMsg, maxnofmsg, pBuffer, 0);
+}
+
+/* ===============================================================================
+* Name: KISS_SPSCRING_CreateEx()
+* Description: Create a single producer/single consumer ring buffer of fixed size items
+*              with additional options.
+* Parameters:   [O] pRB - Pointer to ring buffer
+*               [I] sizeofMsg - Size of each individual message
+*               [I] maxnofmsg - Number of messages in the buffer
+*               [I] pBuffer - Pointer to buffer to use for storage
+*               [I] Flags - Combination of KISS_SPSCRING_FLAG_* options
+* Return: None
+* Caution/Notes: Memory pointed to by pBuffer must be at least sizeofMsg * maxnofmsg bytes.
+*                The ring buffer must be created before either thread uses it.
+================================================================================== */
+void KISS_SPSCRING_CreateEx(KISS_SPSCRING* pRB, KISS_UINT16 sizeofMsg, KISS_UINT maxnofmsg, void* pBuffer, KISS_UINT16 Flags) {
+    KISS_ASSERT(pRB != NULL, "Ring Buffer must be a valid pointer");
+    KISS_ASSERT(pBuffer != NULL, "Storage buffer must not be NULL");
+    KISS_ASSERT(sizeofMsg > 0, "The size of each individual message cannot be zero");
+    KISS_ASSERT(maxnofmsg > 0, "The buffer must have space for at least one element");
+    KISS_ASSERT(maxnofmsg <= 0x7FFFFFFF, "The buffer can have at most 2^31 - 1 elements");
+    KISS_MEMSET(pRB, 0, sizeof(KISS_SPSCRING));
+    pRB->oBuffer = (intptr_t)pBuffer - (intptr_t)pRB;
+    pRB->MaxCount = maxnofmsg;
+    pRB->ItemSize = sizeofMsg;
+    pRB->Flags = Flags;
+    pRB->oTail = 0;
+    pRB->oHeadCache = 0;
+    pRB->oHead = 0;
+    pRB->oTailCache = 0;
+    pRB->SpinLimit = KISS_WAIT_SPIN_MIN;
+    pRB->NumWaiters = 0;
+    pRB->WaitSeq = 0;
+}
+
+/* ===============================================================================
+* Name: KISS_SPSCRING_Delete()
+* Description: Clear the ring buffer.
+* Parameters: [I/O] pRB - Pointer to the Ring Buffer
+* Return: None
+* Caution/Notes: Neither thread may use the ring buffer during or after this call.
+================================================================================== */
+void KISS_SPSCRING_Delete(KISS_SPSCRING* pRB) {
+    KISS_ASSERT(pRB != NULL, "Ring Buffer must be a valid pointer");
+    pRB->oBuffer = 0;
+    pRB->MaxCount = 0;
+    pRB->ItemSize = 0;
+    pRB->Flags = 0;
+    pRB->oTail = 0;
+    pRB->oHeadCache = 0;
+    pRB->oHead = 0;
+    pRB->oTailCache = 0;
+    pRB->SpinLimit = KISS_WAIT_SPIN_MIN;
+    pRB->NumWaiters = 0;
+    pRB->WaitSeq = 0;
+}
+
+/* ===============================================================================
+* Name: KISS_SPSCRING_Put()
+* Description:  Put the element to the end of the ring buffer.
+* Parameters:   [I/O] pRB - Pointer to ring buffer
+*               [I] pElement - Pointer to the element to add at the back of the ring buffer.
+* Return: KISS_BOOL - Returns 0 on success
+* Caution/Notes: Must only be called from the producer thread.
+*                Ownership of pElement is borrowed until function returns.
+================================================================================== */
+KISS_BOOL KISS_SPSCRING_Put(KISS_SPSCRING* pRB, const void* pElement) {
+    KISS_ASSERT(pRB != NULL, "Ring Buffer must be a valid pointer");
+    const KISS_UINT oTail = KISS_ATOMIC_LOAD_RELAXED(&pRB->oTail);
+
+    if (__item_count(pRB, pRB->oHeadCache, oTail) == pRB->MaxCount) {
+        /* Looks full: refresh the cached head from the consumer's cache line */
+        pRB->oHeadCache = KISS_ATOMIC_LOAD(&pRB->oHead);
+        if (__item_count(pRB, pRB->oHeadCache, oTail) == pRB->MaxCount) {
+            return 1;
+        }
+    }
+    void* pDest = &__buffer(pRB)[__index_to_slot(pRB, oTail) * pRB->ItemSize];
+    KISS_MEMCPY(pDest, pElement, pRB->ItemSize);
+    /* Publish the element to the consumer */
+    KISS_ATOMIC_STORE(&pRB->oTail, __next_index(pRB, oTail));
+    if (pRB->Flags & KISS_SPSCRING_FLAG_BLOCKING) {
+        /* Wake the consumer if it is blocked in KISS_SPSCRING_GetWait(). The fence orders
+           the tail store before the waiter check, pairing with the consumer registration */
+        KISS_ATOMIC_FENCE();
+        if (KISS_ATOMIC_LOAD_RELAXED(&pRB->NumWaiters) != 0) {
+            KISS_ATOMIC_FETCH_ADD(&pRB->WaitSeq, 1);
+            KISS_WAIT_WakeAll(&pRB->WaitSeq);
+        }
+    }
+    return 0;
+}
+
+/* ===============================================================================
+* Name: KISS_SPSCRING_Get()
+* Description: Get the top most element of the ring buffer. Will copy data into supplied buffer
+* Parameters:   [I/O] pRB - Pointer to the ring buffer.
+*               [O] pData - Pointer to memory to receive the top most element.
+* Return: KISS_BOOL - Returns 0 on success
+* Caution/Notes: Must only be called from the consumer thread.
+*                The memory pointed to by pData should be at least ItemSize bytes long
+================================================================================== */
+KISS_BOOL KISS_SPSCRING_Get(KISS_SPSCRING* pRB, void* pData) {
+    void* pSrc = NULL;
+    if (pData != NULL && KISS_SPSCRING_GetPtr(pRB, &pSrc) == 0) {
+        KISS_MEMCPY(pData, pSrc, pRB->ItemSize);
+        KISS_SPSCRING_Purge(pRB);
+        return 0;
+    }
+    return 1;
+}
+
+/* ===============================================================================
+* Name: KISS_SPSCRING_GetWait()
+* Description: Get the top most element of the ring buffer, waiting for one to arrive
+*              if the ring buffer is empty.
+* Parameters:   [I/O] pRB - Pointer to the ring buffer.
+*               [O] pData - Pointer to memory to receive the top most element.
+*               [I] TimeoutMs - Maximum time to block in milliseconds. Negative waits forever.
+* Return: KISS_BOOL - Returns 0 on success, non-zero on timeout
+* Caution/Notes: Must only be called from the consumer thread of a ring buffer created
+*                with KISS_SPSCRING_FLAG_BLOCKING. The consumer first polls the ring
+*                buffer; the number of polls adapts to whether polling succeeded last
+*                time. It then blocks until woken by KISS_SPSCRING_Put().
+================================================================================== */
+KISS_BOOL KISS_SPSCRING_GetWait(KISS_SPSCRING* pRB, void* pData, KISS_INT TimeoutMs) {
+    KISS_ASSERT(pRB != NULL, "Ring Buffer must be a valid pointer");
+    KISS_ASSERT(pRB->Flags & KISS_SPSCRING_FLAG_BLOCKING, "The ring buffer must be created with KISS_SPSCRING_FLAG_BLOCKING");
+    const uint64_t Deadline = KISS_WAIT_GetTimeMs() + (uint64_t)KISS_MAX(TimeoutMs, 0);
+
+    for (KISS_UINT i = 0; i < pRB->SpinLimit; ++i) {
+        if (KISS_SPSCRING_Get(pRB, pData) == 0) {
+            pRB->SpinLimit = KISS_MIN(pRB->SpinLimit * 2, KISS_WAIT_SPIN_MAX);
+            return 0;
+        }
+        KISS_WAIT_Pause();
+    }
+    pRB->SpinLimit = KISS_MAX(pRB->SpinLimit / 2, KISS_WAIT_SPIN_MIN);
+
+    for (;;) {
+        const KISS_UINT Seq = KISS_ATOMIC_LOAD(&pRB->WaitSeq);
+        /* Register as a waiter before the final check so a concurrent Put either
+           sees the waiter or its element is seen by the check */
+        KISS_ATOMIC_FETCH_ADD(&pRB->NumWaiters, 1);
+        if (KISS_SPSCRING_Get(pRB, pData) == 0) {
+            KISS_ATOMIC_FETCH_ADD(&pRB->NumWaiters, (KISS_UINT)-1);
+            return 0;
+        }
+        /* Spurious wakes must not restart the full timeout */
+        const KISS_INT RemainingMs = KISS_WAIT_RemainingMs(Deadline, TimeoutMs);
+        const int TimedOut = (RemainingMs == 0) || KISS_WAIT_Wait(&pRB->WaitSeq, Seq, RemainingMs);
+        KISS_ATOMIC_FETCH_ADD(&pRB->NumWaiters, (KISS_UINT)-1);
+        if (TimedOut) {
+            return KISS_SPSCRING_Get(pRB, pData);
+        }
+    }
+}
+
+/* ===============================================================================
+* Name: KISS_SPSCRING_GetPtr()
+* Description: Get a pointer to the message at the front of the ring buffer.
+* Parameters: [I] pRB - Pointer to the ring buffer
+*             [O] ppDest - Pointer to pointer to the first element.
+* Return: KISS_BOOL - Returns 0 on success
+* Caution/Notes: Must only be called from the consumer thread. The element remains
+*                owned by the consumer until KISS_SPSCRING_Purge() is called.
+================================================================================== */
+KISS_BOOL KISS_SPSCRING_GetPtr(KISS_SPSCRING* pRB, void** ppDest) {
+    KISS_ASSERT(pRB != NULL, "Ring Buffer must be a valid pointer");
+    const KISS_UINT oHead = KISS_ATOMIC_LOAD_RELAXED(&pRB->oHead);
+
+    if (ppDest != NULL) {
+        if (oHead == pRB->oTailCache) {
+            /* Looks empty: refresh the cached tail from the producer's cache line */
+            pRB->oTailCache = KISS_ATOMIC_LOAD(&pRB->oTail);
+            if (oHead == pRB->oTailCache) {
+                return 1;
+            }
+        }
+        *ppDest = &__buffer(pRB)[__index_to_slot(pRB, oHead) * pRB->ItemSize];
+        return 0;
+    }
+    return 1;
+}
+
+/* ===============================================================================
+* Name: KISS_SPSCRING_Purge()
+* Description: Remove the front element from the ring buffer. Used in conjunction with KISS_SPSCRING_GetPtr()
+* Parameters: [I/O] pRB - Pointer to the ring buffer
+* Return: None
+* Caution/Notes: Must only be called from the consumer thread after a successful
+*                call to KISS_SPSCRING_GetPtr().
+================================================================================== */
+void KISS_SPSCRING_Purge(KISS_SPSCRING* pRB) {
+    KISS_ASSERT(pRB != NULL, "Ring Buffer must be a valid pointer");
+    const KISS_UINT oHead = KISS_ATOMIC_LOAD_RELAXED(&pRB->oHead);
+    if (oHead != pRB->oTailCache) {
+        /* Hand the slot back to the producer */
+        KISS_ATOMIC_STORE(&pRB->oHead, __next_index(pRB, oHead));
+    }
+}
+
+/* ===============================================================================
+* Name: KISS_SPSCRING_GetItemCnt()
+* Description: Get the number of elements in the ring buffer.
+* Parameters: [I] pRB - Pointer to the ring buffer
+* Return: int - Number of elements in the ring buffer
+* Caution/Notes: The result is only a snapshot if the other thread is active.
+================================================================================== */
+int KISS_SPSCRING_GetItemCnt(const KISS_SPSCRING* pRB) {
+    KISS_ASSERT(pRB != NULL, "Ring Buffer must be a valid pointer");
+    const KISS_UINT oHead = KISS_ATOMIC_LOAD(&pRB->oHead);
+    const KISS_UINT oTail = KISS_ATOMIC_LOAD(&pRB->oTail);
+    return (int)KISS_MIN(__item_count(pRB, oHead, oTail), pRB->MaxCount);
+}
+
+static KISS_UINT __next_index(const KISS_SPSCRING* pRB, KISS_UINT o) {
+    o++;
+    return (o == 2 * pRB->MaxCount) ? 0 : o;
+}
+
+static KISS_UINT __index_to_slot(const KISS_SPSCRING* pRB, KISS_UINT o) {
+    return (o < pRB->MaxCount) ? o : o - pRB->MaxCount;
+}
+
+static KISS_UINT __item_count(const KISS_SPSCRING* pRB, KISS_UINT oHead, KISS_UINT oTail) {
+    return (oTail >= oHead) ? oTail - oHead : oTail + 2 * pRB->MaxCount - oHead;
+}
+
+static uint8_t* __buffer(const KISS_SPSCRING* pRB) {
+    return (uint8_t*)pRB + pRB->oBuffer;
+}
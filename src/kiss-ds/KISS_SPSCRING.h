@@ -0,0 +1,101 @@
+/*================================================================================
+*   zlib/libpng license
+*
+*   Copyright (c) 2021. Denis Hilliard
+*
+*   This software is provided 'as-is', without any express or implied warranty.
+*    In no event will the authors be held liable for any damages arising from the
+*    use of this software.
+*
+*    Permission is granted to anyone to use this software for any purpose,
+*    including commercial applications, and to alter it and redistribute it
+*    freely, subject to the following restrictions:
+*
+*        1. The origin of this software must not be misrepresented; you must not
+*        claim that you wrote the original software. If you use this software in a
+*        product, an acknowledgment in the product documentation would be
+*        appreciated but is not required.
+*
+*        2. Altered source versions must be plainly marked as such, and must not
+*        be misrepresented as being the original software.
+*
+*        3. This notice may not be removed or altered from any source
+*        distribution.
+*
+*   Component: Single Producer/Single Consumer Ring Buffer
+*   File: KISS_SPSCRING.h
+*   Description:  This file implements the logic for a lock-free fixed size ring
+*                 buffer shared between one producer and one consumer thread.
+*   Caution/Notes:  None
+*=================================================================================*/
+#ifndef _KISS_SPSCRING_H_
+#define _KISS_SPSCRING_H_
+
+#include "KISS_Common.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+/*
+KISS_SPSCRING implements a ring buffer that can be used as a mailbox for fixed size
+messages between exactly one producer thread and one consumer thread without locking.
+The producer and consumer indices live on separate cache lines and each side keeps
+a cached copy of the other side's index so the shared cache line is only read when
+the ring appears full/empty.
+Indices run from 0 to 2 * MaxCount - 1 so a full ring can be told apart from an empty one.
+With KISS_SPSCRING_FLAG_BLOCKING the consumer can block in KISS_SPSCRING_GetWait().
+The producer then checks for a registered waiter after every Put, which costs a full fence,
+and only issues a wake (syscall) when there is one. Without the flag Put is a single release store.
+*/
+typedef struct {
+    /* Read-only after creation. The storage is addressed relative to the ring buffer
+       object so both can be placed in shared memory, see KISS_SHM */
+    intptr_t oBuffer;
+    KISS_UINT MaxCount;
+    KISS_UINT16 ItemSize;
+    KISS_UINT16 Flags;
+    uint8_t Pad0[KISS_CACHELINE_SIZE];
+    /* Written by the producer only */
+    KISS_UINT oTail;
+    KISS_UINT oHeadCache;
+    uint8_t Pad1[KISS_CACHELINE_SIZE - 2 * sizeof(KISS_UINT)];
+    /* Written by the consumer only */
+    KISS_UINT oHead;
+    KISS_UINT oTailCache;
+    KISS_UINT SpinLimit;
+    uint8_t Pad2[KISS_CACHELINE_SIZE - 3 * sizeof(KISS_UINT)];
+    /* Blocking consumer support */
+    KISS_UINT NumWaiters;
+    KISS_UINT WaitSeq;
+    uint8_t Pad3[KISS_CACHELINE_SIZE - 2 * sizeof(KISS_UINT)];
+} KISS_SPSCRING;
+
+/* Flags for KISS_SPSCRING_CreateEx() */
+/* The consumer may block in KISS_SPSCRING_GetWait(), Put wakes it */
+#define KISS_SPSCRING_FLAG_BLOCKING 0x0001
+
+/* Create a ring buffer using the buffer as the backing storage */
+void KISS_SPSCRING_Create(KISS_SPSCRING* pRB, KISS_UINT16 sizeofMsg, KISS_UINT maxnofmsg, void* pBuffer);
+/* Create a ring buffer with the specified KISS_SPSCRING_FLAG_* options */
+void KISS_SPSCRING_CreateEx(KISS_SPSCRING* pRB, KISS_UINT16 sizeofMsg, KISS_UINT maxnofmsg, void* pBuffer, KISS_UINT16 Flags);
+/* Clear the ring buffer to the uninitialised state */
+void KISS_SPSCRING_Delete(KISS_SPSCRING* pRB);
+/* Get the number of items currently in the ring buffer. Only a snapshot when called concurrently. */
+int KISS_SPSCRING_GetItemCnt(const KISS_SPSCRING* pRB);
+
+/* Producer side. Returns 0 on success */
+KISS_BOOL KISS_SPSCRING_Put(KISS_SPSCRING* pRB, const void* pElement);
+
+/* Consumer side. These functions all return 0 on success */
+KISS_BOOL KISS_SPSCRING_Get(KISS_SPSCRING* pRB, void* pData);
+/* Spin for a bounded time, then block for up to TimeoutMs milliseconds (negative waits forever) until an element arrives.
+   Requires KISS_SPSCRING_FLAG_BLOCKING */
+KISS_BOOL KISS_SPSCRING_GetWait(KISS_SPSCRING* pRB, void* pData, KISS_INT TimeoutMs);
+KISS_BOOL KISS_SPSCRING_GetPtr(KISS_SPSCRING* pRB, void** ppDest);
+/* Must be used with KISS_SPSCRING_GetPtr() to release the element to the producer */
+void KISS_SPSCRING_Purge(KISS_SPSCRING* pRB);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,279 @@
+/*================================================================================
+*   zlib/libpng license
+*
+*   Copyright (c) 2021. Denis Hilliard
+*
+*   This software is provided 'as-is', without any express or implied warranty.
+*    In no event will the authors be held liable for any damages arising from the
+*    use of this software.
+*
+*    Permission is granted to anyone to use this software for any purpose,
+*    including commercial applications, and to alter it and redistribute it
+*    freely, subject to the following restrictions:
+*
+*        1. The origin of this software must not be misrepresented; you must not
+*        claim that you wrote the original software. If you use this software in a
+*        product, an acknowledgment in the product documentation would be
+*        appreciated but is not required.
+*
+*        2. Altered source versions must be plainly marked as such, and must not
+*        be misrepresented as being the original software.
+*
+*        3. This notice may not be removed or altered from any source
+*        distribution.
+*
+*   Component: Virtual Memory Mirrored Ring Buffer
+*   File: KISS_VRING.c
+*   Description:  This file implements the logic for a byte ring buffer whose storage
+*                 is mapped twice back to back so that data never wraps.
+*   Caution/Notes:  Only available on POSIX systems.
+*=================================================================================*/
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+#include "KISS_VRING.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+/* Internal function to create an anonymous shared memory object of Size bytes. Returns the file descriptor or -1 */
+static int __create_shm(KISS_UINT Size);
+#endif
+
+/* ===============================================================================
+* Name: KISS_VRING_Create()
+* Description: Create a mirrored ring buffer of at least MinSize bytes.
+* Parameters:   [O] pVR - Pointer to ring buffer
+*               [I] MinSize - Minimum capacity (in bytes) of the ring buffer
+* Return: int - Returns 0 on success
+* Caution/Notes: The capacity is rounded up to a multiple of the page size.
+*                The storage is mapped twice so 2 * Size bytes of address space are used.
+*                Always fails on platforms without POSIX shared memory.
+================================================================================== */
+int KISS_VRING_Create(KISS_VRING* pVR, KISS_UINT MinSize) {
+    KISS_ASSERT(pVR != NULL, "Ring Buffer must be a valid pointer");
+    KISS_ASSERT(MinSize > 0, "The ring buffer must have space for at least one byte");
+    KISS_MEMSET(pVR, 0, sizeof(KISS_VRING));
+#if defined(__unix__) || defined(__APPLE__)
+    const KISS_UINT PageSize = (KISS_UINT)sysconf(_SC_PAGESIZE);
+    const KISS_UINT Size = KISS_ALIGN_UP(MinSize, PageSize);
+    int fd = __create_shm(Size);
+    if (fd < 0) {
+        return 1;
+    }
+    /* Reserve the address space for both mappings, then map the same pages into each half */
+    uint8_t* pBase = mmap(NULL, 2 * (size_t)Size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (pBase == MAP_FAILED) {
+        close(fd);
+        return 1;
+    }
+    if (mmap(pBase, Size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED ||
+        mmap(pBase + Size, Size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED) {
+        munmap(pBase, 2 * (size_t)Size);
+        close(fd);
+        return 1;
+    }
+    /* The mappings keep the memory object alive */
+    close(fd);
+    pVR->pBuffer = pBase;
+    pVR->Size = Size;
+    return 0;
+#else
+    return 1;
+#endif
+}
+
+/* ===============================================================================
+* Name: KISS_VRING_Delete()
+* Description: Release the storage and clear the ring buffer.
+* Parameters: [I/O] pVR - Pointer to the Ring Buffer
+* Return: None
+* Caution/Notes: None
+================================================================================== */
+void KISS_VRING_Delete(KISS_VRING* pVR) {
+    KISS_ASSERT(pVR != NULL, "Ring Buffer must be a valid pointer");
+#if defined(__unix__) || defined(__APPLE__)
+    if (pVR->pBuffer != NULL) {
+        munmap(pVR->pBuffer, 2 * (size_t)pVR->Size);
+    }
+#endif
+    pVR->pBuffer = NULL;
+    pVR->Size = 0;
+    pVR->NumUsed = 0;
+    pVR->oHead = 0;
+    pVR->oTail = 0;
+}
+
+/* ===============================================================================
+* Name: KISS_VRING_Clear()
+* Description: Update the head of the ring buffer to remove any data contained therein.
+* Parameters: [I/O] pVR - Pointer to the Ring Buffer
+* Return: None
+* Caution/Notes: Does not modify the memory of the ring buffer
+================================================================================== */
+void KISS_VRING_Clear(KISS_VRING* pVR) {
+    KISS_ASSERT(pVR != NULL, "Ring Buffer must be a valid pointer");
+    pVR->oHead = pVR->oTail;
+    pVR->NumUsed = 0;
+}
+
+/* ===============================================================================
+* Name: KISS_VRING_GetByteCnt()
+* Description: Get the number of bytes in the ring buffer.
+* Parameters: [I] pVR - Pointer to the ring buffer
+* Return: KISS_UINT - Number of bytes in the ring buffer
+* Caution/Notes: None
+================================================================================== */
+KISS_UINT KISS_VRING_GetByteCnt(const KISS_VRING* pVR) {
+    KISS_ASSERT(pVR != NULL, "Ring Buffer must be a valid pointer");
+    return pVR->NumUsed;
+}
+
+/* ===============================================================================
+* Name: KISS_VRING_GetSize()
+* Description: Get the capacity of the ring buffer.
+* Parameters: [I] pVR - Pointer to the ring buffer
+* Return: KISS_UINT - Capacity (in bytes) of the ring buffer
+* Caution/Notes: None
+================================================================================== */
+KISS_UINT KISS_VRING_GetSize(const KISS_VRING* pVR) {
+    KISS_ASSERT(pVR != NULL, "Ring Buffer must be a valid pointer");
+    return pVR->Size;
+}
+
+/* ===============================================================================
+* Name: KISS_VRING_Write()
+* Description:  Copy up to Len bytes to the end of the ring buffer.
+* Parameters:   [I/O] pVR - Pointer to ring buffer
+*               [I] pSrc - Pointer to the data to add
+*               [I] Len - Number of bytes to add
+* Return: KISS_UINT - Number of bytes added to the ring buffer
+* Caution/Notes: Ownership of pSrc is borrowed until function returns.
+================================================================================== */
+KISS_UINT KISS_VRING_Write(KISS_VRING* pVR, const void* pSrc, KISS_UINT Len) {
+    void* pDest = NULL;
+    const KISS_UINT Num = KISS_MIN(Len, KISS_VRING_GetWritePtr(pVR, &pDest));
+    if (Num > 0 && pSrc != NULL) {
+        KISS_MEMCPY(pDest, pSrc, Num);
+        KISS_VRING_Commit(pVR, Num);
+        return Num;
+    }
+    return 0;
+}
+
+/* ===============================================================================
+* Name: KISS_VRING_Read()
+* Description:  Copy up to Len bytes from the front of the ring buffer.
+* Parameters:   [I/O] pVR - Pointer to ring buffer
+*               [O] pDst - Pointer to memory to receive the data
+*               [I] Len - Maximum number of bytes to retrieve
+* Return: KISS_UINT - Number of bytes removed from the ring buffer
+* Caution/Notes: None
+================================================================================== */
+KISS_UINT KISS_VRING_Read(KISS_VRING* pVR, void* pDst, KISS_UINT Len) {
+    void* pSrc = NULL;
+    const KISS_UINT Num = KISS_MIN(Len, KISS_VRING_GetReadPtr(pVR, &pSrc));
+    if (Num > 0 && pDst != NULL) {
+        KISS_MEMCPY(pDst, pSrc, Num);
+        KISS_VRING_Purge(pVR, Num);
+        return Num;
+    }
+    return 0;
+}
+
+/* ===============================================================================
+* Name: KISS_VRING_GetWritePtr()
+* Description: Get a pointer to the free space at the end of the ring buffer.
+* Parameters: [I/O] pVR - Pointer to the ring buffer
+*             [O] ppDest - Pointer to pointer to the free space
+* Return: KISS_UINT - Number of contiguous free bytes at *ppDest.
+* Caution/Notes: The free space is always contiguous. Data written to it is not
+*                visible until KISS_VRING_Commit() is called.
+================================================================================== */
+KISS_UINT KISS_VRING_GetWritePtr(KISS_VRING* pVR, void** ppDest) {
+    KISS_ASSERT(pVR != NULL, "Ring Buffer must be a valid pointer");
+    if (ppDest != NULL) {
+        *ppDest = &pVR->pBuffer[pVR->oTail];
+        return pVR->Size - pVR->NumUsed;
+    }
+    return 0;
+}
+
+/* ===============================================================================
+* Name: KISS_VRING_Commit()
+* Description: Add bytes written through KISS_VRING_GetWritePtr() to the ring buffer.
+* Parameters: [I/O] pVR - Pointer to the ring buffer
+*             [I] Len - Number of bytes to add
+* Return: None
+* Caution/Notes: None
+================================================================================== */
+void KISS_VRING_Commit(KISS_VRING* pVR, KISS_UINT Len) {
+    KISS_ASSERT(pVR != NULL, "Ring Buffer must be a valid pointer");
+    KISS_ASSERT(Len <= pVR->Size - pVR->NumUsed, "Cannot commit more than the free space");
+    pVR->oTail += Len;
+    if (pVR->oTail >= pVR->Size) {
+        pVR->oTail -= pVR->Size;
+    }
+    pVR->NumUsed += Len;
+}
+
+/* ===============================================================================
+* Name: KISS_VRING_GetReadPtr()
+* Description: Get a pointer to the data at the front of the ring buffer.
+* Parameters: [I] pVR - Pointer to the ring buffer
+*             [O] ppData - Pointer to pointer to the pending data
+* Return: KISS_UINT - Number of contiguous pending bytes at *ppData.
+* Caution/Notes: All pending data is always contiguous.
+================================================================================== */
+KISS_UINT KISS_VRING_GetReadPtr(const KISS_VRING* pVR, void** ppData) {
+    KISS_ASSERT(pVR != NULL, "Ring Buffer must be a valid pointer");
+    if (ppData != NULL) {
+        *ppData = &pVR->pBuffer[pVR->oHead];
+        return pVR->NumUsed;
+    }
+    return 0;
+}
+
+/* ===============================================================================
+* Name: KISS_VRING_Purge()
+* Description: Remove bytes from the front of the ring buffer.
+* Parameters: [I/O] pVR - Pointer to the ring buffer
+*             [I] Len - Number of bytes to remove
+* Return: None
+* Caution/Notes: None
+================================================================================== */
+void KISS_VRING_Purge(KISS_VRING* pVR, KISS_UINT Len) {
+    KISS_ASSERT(pVR != NULL, "Ring Buffer must be a valid pointer");
+    Len = KISS_MIN(Len, pVR->NumUsed);
+    pVR->oHead += Len;
+    if (pVR->oHead >= pVR->Size) {
+        pVR->oHead -= pVR->Size;
+    }
+    pVR->NumUsed -= Len;
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+static int __create_shm(KISS_UINT Size) {
+    int fd = -1;
+#if defined(__linux__)
+    fd = memfd_create("kiss-vring", MFD_CLOEXEC);
+#else
+    /* Create a uniquely named object and unlink it straight away so it is released with the mappings */
+    static KISS_UINT Counter = 0;
+    char Name[64];
+    snprintf(Name, sizeof(Name), "/kiss-vring-%ld-%u", (long)getpid(), Counter++);
+    fd = shm_open(Name, O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd >= 0) {
+        shm_unlink(Name);
+    }
+#endif
+    if (fd >= 0 && ftruncate(fd, (off_t)Size) != 0) {
+        close(fd);
+        fd = -1;
+    }
+    return fd;
+}
+#endif
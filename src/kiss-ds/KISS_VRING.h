@@ -0,0 +1,81 @@
+/*================================================================================
+*   zlib/libpng license
+*
+*   Copyright (c) 2021. Denis Hilliard
+*
+*   This software is provided 'as-is', without any express or implied warranty.
+*    In no event will the authors be held liable for any damages arising from the
+*    use of this software.
+*
+*    Permission is granted to anyone to use this software for any purpose,
+*    including commercial applications, and to alter it and redistribute it
+*    freely, subject to the following restrictions:
+*
+*        1. The origin of this software must not be misrepresented; you must not
+*        claim that you wrote the original software. If you use this software in a
+*        product, an acknowledgment in the product documentation would be
+*        appreciated but is not required.
+*
+*        2. Altered source versions must be plainly marked as such, and must not
+*        be misrepresented as being the original software.
+*
+*        3. This notice may not be removed or altered from any source
+*        distribution.
+*
+*   Component: Virtual Memory Mirrored Ring Buffer
+*   File: KISS_VRING.h
+*   Description:  This file implements the logic for a byte ring buffer whose storage
+*                 is mapped twice back to back so that data never wraps.
+*   Caution/Notes:  Only available on POSIX systems.
+*=================================================================================*/
+#ifndef _KISS_VRING_H_
+#define _KISS_VRING_H_
+
+#include "KISS_Common.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+/*
+KISS_VRING implements a byte ring buffer backed by a shared memory object whose pages are
+mapped twice, back to back. Any span of up to Size bytes starting inside the first mapping
+is contiguous in virtual memory, so readers and parsers can work directly on ring memory
+without handling the wrap point or copying into a scratch area.
+Unlike the other data structures the storage is allocated by KISS_VRING_Create().
+*/
+typedef struct {
+    uint8_t* pBuffer;
+    KISS_UINT Size;
+    KISS_UINT NumUsed;
+    KISS_UINT oHead;
+    KISS_UINT oTail;
+} KISS_VRING;
+
+/* Create a ring buffer of at least MinSize bytes. Size is rounded up to the page size. Returns 0 on success */
+int KISS_VRING_Create(KISS_VRING* pVR, KISS_UINT MinSize);
+/* Release the mapping and clear the ring buffer to the uninitialised state */
+void KISS_VRING_Delete(KISS_VRING* pVR);
+/* Remove any pending data in the ring buffer */
+void KISS_VRING_Clear(KISS_VRING* pVR);
+/* Get the number of bytes currently in the ring buffer */
+KISS_UINT KISS_VRING_GetByteCnt(const KISS_VRING* pVR);
+/* Get the capacity (in bytes) of the ring buffer */
+KISS_UINT KISS_VRING_GetSize(const KISS_VRING* pVR);
+
+/* Copy up to Len bytes in/out of the ring buffer. These functions return the number of bytes transferred */
+KISS_UINT KISS_VRING_Write(KISS_VRING* pVR, const void* pSrc, KISS_UINT Len);
+KISS_UINT KISS_VRING_Read(KISS_VRING* pVR, void* pDst, KISS_UINT Len);
+
+/* Get a pointer to all free space as one contiguous span. Returns the number of free bytes */
+KISS_UINT KISS_VRING_GetWritePtr(KISS_VRING* pVR, void** ppDest);
+/* Must be used with KISS_VRING_GetWritePtr() to add Len written bytes to the ring buffer */
+void KISS_VRING_Commit(KISS_VRING* pVR, KISS_UINT Len);
+/* Get a pointer to all pending data as one contiguous span. Returns the number of pending bytes */
+KISS_UINT KISS_VRING_GetReadPtr(const KISS_VRING* pVR, void** ppData);
+/* Must be used with KISS_VRING_GetReadPtr() to remove Len bytes from the ring buffer */
+void KISS_VRING_Purge(KISS_VRING* pVR, KISS_UINT Len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,154 @@
+/*================================================================================
+*   zlib/libpng license
+*
+*   Copyright (c) 2021. Denis Hilliard
+*
+*   This software is provided 'as-is', without any express or implied warranty.
+*    In no event will the authors be held liable for any damages arising from the
+*    use of this software.
+*
+*    Permission is granted to anyone to use this software for any purpose,
+*    including commercial applications, and to alter it and redistribute it
+*    freely, subject to the following restrictions:
+*
+*        1. The origin of this software must not be misrepresented; you must not
+*        claim that you wrote the original software. If you use this software in a
+*        product, an acknowledgment in the product documentation would be
+*        appreciated but is not required.
+*
+*        2. Altered source versions must be plainly marked as such, and must not
+*        be misrepresented as being the original software.
+*
+*        3. This notice may not be removed or altered from any source
+*        distribution.
+*
+*   Component: Wait/Notify
+*   File: KISS_WAIT.c
+*   Description:  This file implements blocking on a 32-bit word until another
+*                 thread changes it, used by the concurrent data structures.
+*   Caution/Notes:  Uses futex on Linux and WaitOnAddress on Windows. Other
+*                   platforms fall back to polling with short sleeps.
+*=================================================================================*/
+#include "KISS_WAIT.h"
+
+#if defined(__linux__)
+#include <errno.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#elif defined(_WIN32)
+#include <windows.h>
+#pragma comment(lib, "Synchronization.lib")
+#else
+#include <time.h>
+#endif
+
+#if (defined(__i386__) || defined(__x86_64__)) && !defined(_MSC_VER)
+#include <immintrin.h>
+#endif
+
+/* ===============================================================================
+* Name: KISS_WAIT_Wait()
+* Description: Block the calling thread while the word still holds the expected value.
+* Parameters:   [I] pWord - Pointer to the word to wait on
+*               [I] Expected - Value the word is expected to hold
+*               [I] TimeoutMs - Maximum time to wait in milliseconds. Negative waits forever.
+* Return: int - Returns 0 when woken or the word changed, 1 on timeout
+* Caution/Notes: Wakeups may be spurious, callers must re-check their condition.
+================================================================================== */
+int KISS_WAIT_Wait(KISS_UINT* pWord, KISS_UINT Expected, KISS_INT TimeoutMs) {
+    KISS_ASSERT(pWord != NULL, "Wait word must be a valid pointer");
+#if defined(__linux__)
+    struct timespec ts;
+    ts.tv_sec = TimeoutMs / 1000;
+    ts.tv_nsec = (long)(TimeoutMs % 1000) * 1000000;
+    /* Not FUTEX_WAIT_PRIVATE: the word may live in memory shared between processes */
+    if (syscall(SYS_futex, pWord, FUTEX_WAIT, Expected, (TimeoutMs < 0) ? NULL : &ts, NULL, 0) != 0) {
+        return (errno == ETIMEDOUT) ? 1 : 0;
+    }
+    return 0;
+#elif defined(_WIN32)
+    if (!WaitOnAddress(pWord, &Expected, sizeof(KISS_UINT), (TimeoutMs < 0) ? INFINITE : (DWORD)TimeoutMs)) {
+        return (GetLastError() == ERROR_TIMEOUT) ? 1 : 0;
+    }
+    return 0;
+#else
+    /* Poll the word every 100us */
+    const struct timespec ts = { 0, 100000 };
+    for (KISS_INT Elapsed = 0; TimeoutMs < 0 || Elapsed < TimeoutMs * 10; ++Elapsed) {
+        if (KISS_ATOMIC_LOAD(pWord) != Expected) {
+            return 0;
+        }
+        nanosleep(&ts, NULL);
+    }
+    return (KISS_ATOMIC_LOAD(pWord) != Expected) ? 0 : 1;
+#endif
+}
+
+/* ===============================================================================
+* Name: KISS_WAIT_WakeAll()
+* Description: Wake all threads blocked in KISS_WAIT_Wait() on the word.
+* Parameters:   [I] pWord - Pointer to the word
+* Return: None
+* Caution/Notes: The word should be changed before calling this function.
+================================================================================== */
+void KISS_WAIT_WakeAll(KISS_UINT* pWord) {
+    KISS_ASSERT(pWord != NULL, "Wait word must be a valid pointer");
+#if defined(__linux__)
+    syscall(SYS_futex, pWord, FUTEX_WAKE, 0x7FFFFFFF, NULL, NULL, 0);
+#elif defined(_WIN32)
+    WakeByAddressAll(pWord);
+#endif
+}
+
+/* ===============================================================================
+* Name: KISS_WAIT_Pause()
+* Description: Hint to the processor that the caller is in a spin loop.
+* Parameters: None
+* Return: None
+* Caution/Notes: None
+================================================================================== */
+void KISS_WAIT_Pause(void) {
+#if defined(_MSC_VER)
+    YieldProcessor();
+#elif defined(__i386__) || defined(__x86_64__)
+    _mm_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+/* ===============================================================================
+* Name: KISS_WAIT_GetTimeMs()
+* Description: Get the current time of a monotonic clock.
+* Parameters: None
+* Return: uint64_t - Milliseconds since an unspecified starting point
+* Caution/Notes: Only the difference between two timestamps is meaningful.
+================================================================================== */
+uint64_t KISS_WAIT_GetTimeMs(void) {
+#if defined(_WIN32)
+    return (uint64_t)GetTickCount64();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + (uint64_t)ts.tv_nsec / 1000000;
+#endif
+}
+
+/* ===============================================================================
+* Name: KISS_WAIT_RemainingMs()
+* Description: Get the time left to wait until a deadline.
+* Parameters:   [I] Deadline - KISS_WAIT_GetTimeMs() timestamp the wait must end by
+*               [I] TimeoutMs - Timeout the deadline was computed from. Negative waits forever.
+* Return: KISS_INT - Milliseconds left, 0 once the deadline has passed, -1 to wait forever
+* Caution/Notes: Used by waiters that loop around KISS_WAIT_Wait() so spurious wakes
+*                don't restart the full timeout.
+================================================================================== */
+KISS_INT KISS_WAIT_RemainingMs(uint64_t Deadline, KISS_INT TimeoutMs) {
+    if (TimeoutMs < 0) {
+        return -1;
+    }
+    const uint64_t Now = KISS_WAIT_GetTimeMs();
+    return (Now >= Deadline) ? 0 : (KISS_INT)(Deadline - Now);
+}
@@ -0,0 +1,65 @@
+/*================================================================================
+*   zlib/libpng license
+*
+*   Copyright (c) 2021. Denis Hilliard
+*
+*   This software is provided 'as-is', without any express or implied warranty.
+*    In no event will the authors be held liable for any damages arising from the
+*    use of this software.
+*
+*    Permission is granted to anyone to use this software for any purpose,
+*    including commercial applications, and to alter it and redistribute it
+*    freely, subject to the following restrictions:
+*
+*        1. The origin of this software must not be misrepresented; you must not
+*        claim that you wrote the original software. If you use this software in a
+*        product, an acknowledgment in the product documentation would be
+*        appreciated but is not required.
+*
+*        2. Altered source versions must be plainly marked as such, and must not
+*        be misrepresented as being the original software.
+*
+*        3. This notice may not be removed or altered from any source
+*        distribution.
+*
+*   Component: Wait/Notify
+*   File: KISS_WAIT.h
+*   Description:  This file implements blocking on a 32-bit word until another
+*                 thread changes it, used by the concurrent data structures.
+*   Caution/Notes:  Uses futex on Linux and WaitOnAddress on Windows. Other
+*                   platforms fall back to polling with short sleeps.
+*=================================================================================*/
+#ifndef _KISS_WAIT_H_
+#define _KISS_WAIT_H_
+
+#include "KISS_Common.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Number of polls a waiter performs before it blocks in the kernel */
+#ifndef KISS_WAIT_SPIN_MAX
+#define KISS_WAIT_SPIN_MAX 4096
+#endif
+#ifndef KISS_WAIT_SPIN_MIN
+#define KISS_WAIT_SPIN_MIN 16
+#endif
+
+/* Block while *pWord == Expected for up to TimeoutMs milliseconds (negative waits forever).
+   Returns 0 when woken or *pWord no longer matches, 1 on timeout. May wake spuriously. */
+int KISS_WAIT_Wait(KISS_UINT* pWord, KISS_UINT Expected, KISS_INT TimeoutMs);
+/* Wake all threads blocked on pWord */
+void KISS_WAIT_WakeAll(KISS_UINT* pWord);
+/* Hint to the processor that the caller is spinning */
+void KISS_WAIT_Pause(void);
+/* Get a monotonic timestamp in milliseconds */
+uint64_t KISS_WAIT_GetTimeMs(void);
+/* Get the milliseconds left until Deadline (a KISS_WAIT_GetTimeMs() timestamp), 0 once passed.
+   Returns -1 (wait forever) when the original TimeoutMs was negative */
+KISS_INT KISS_WAIT_RemainingMs(uint64_t Deadline, KISS_INT TimeoutMs);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
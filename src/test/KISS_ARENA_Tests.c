@@ -48,3 +48,153 @@ UTEST(KISS_ARENA, WillNotOverflow) {
     KISS_ARENA_Delete(&arena);
 }
 
+
+/* This test validates that allocations stay within the buffer */
+UTEST(KISS_ARENA, StaysWithinBuffer) {
+    uint8_t buffer[66] = { 0 };
+    KISS_ARENA arena;
+    /* Use the 64 bytes in the middle, the guard bytes must not be touched */
+    KISS_ARENA_Create(&arena, buffer + 1, 64);
+    uint8_t* pData = (uint8_t*)KISS_ARENA_Alloc(&arena, 64);
+    ASSERT_NE(pData, NULL);
+    EXPECT_EQ(pData, buffer + 1);
+    KISS_MEMSET(pData, 0xFF, 64);
+    EXPECT_EQ(KISS_ARENA_Alloc(&arena, 1), NULL);
+    EXPECT_EQ(buffer[0], 0);
+    EXPECT_EQ(buffer[65], 0);
+
+    KISS_ARENA_Clear(&arena);
+    pData = (uint8_t*)KISS_ARENA_AllocEx(&arena, 8, 8);
+    ASSERT_NE(pData, NULL);
+    const uintptr_t misalign = (uintptr_t)pData % 8;
+    EXPECT_EQ(misalign, 0);
+    EXPECT_LE(pData + 8, buffer + 65);
+    KISS_ARENA_Delete(&arena);
+}
+
+typedef struct {
+    int NumAlloc;
+    int NumFree;
+    KISS_UINT LastSize;
+} ArenaBlockStats;
+
+static void* ArenaTestAlloc(void* pUser, KISS_UINT Size) {
+    ArenaBlockStats* pStats = (ArenaBlockStats*)pUser;
+    pStats->NumAlloc++;
+    pStats->LastSize = Size;
+    return malloc(Size);
+}
+
+static void ArenaTestFree(void* pUser, void* pBlock) {
+    ((ArenaBlockStats*)pUser)->NumFree++;
+    free(pBlock);
+}
+
+/* This test validates that a growable arena spills into larger blocks and Clear keeps the largest */
+UTEST(KISS_ARENA, GrowableSpillsIntoBlocks) {
+    KISS_UINT buffer[256 / sizeof(KISS_UINT)];
+    ArenaBlockStats stats = { 0, 0, 0 };
+    KISS_ARENA arena;
+    KISS_ARENA_CreateGrowable(&arena, buffer, sizeof(buffer), ArenaTestAlloc, ArenaTestFree, &stats);
+
+    /* The first 64 allocations fit into the buffer */
+    for (KISS_UINT i = 0; i < 64; ++i) {
+        KISS_UINT* pValue = (KISS_UINT*)KISS_ARENA_Alloc(&arena, sizeof(KISS_UINT));
+        ASSERT_NE(pValue, NULL);
+        *pValue = i;
+    }
+    EXPECT_EQ(stats.NumAlloc, 0);
+    KISS_UINT* pFirst = (KISS_UINT*)KISS_ARENA_Alloc(&arena, sizeof(KISS_UINT));
+    ASSERT_NE(pFirst, NULL);
+    EXPECT_EQ(stats.NumAlloc, 1);
+    EXPECT_GE(stats.LastSize, KISS_ARENA_MIN_BLOCK_SIZE);
+
+    /* A request larger than twice the block gets a block of its own size, aligned */
+    uint8_t* pLarge = (uint8_t*)KISS_ARENA_AllocEx(&arena, 100000, 64);
+    ASSERT_NE(pLarge, NULL);
+    const uintptr_t misalign = (uintptr_t)pLarge % 64;
+    EXPECT_EQ(misalign, 0);
+    KISS_MEMSET(pLarge, 0, 100000);
+    EXPECT_EQ(stats.NumAlloc, 2);
+    EXPECT_GE(stats.LastSize, 100000);
+    /* Blocks keep growing geometrically */
+    const KISS_UINT last_size = stats.LastSize;
+    ASSERT_NE(KISS_ARENA_Alloc(&arena, last_size / 2), NULL);
+    EXPECT_EQ(stats.NumAlloc, 3);
+    EXPECT_GE(stats.LastSize, 2 * (last_size - 64));
+    /* The bytes allocated include the alignment padding */
+    EXPECT_GE(KISS_ARENA_BytesAllocated(&arena), (int)(65 * sizeof(KISS_UINT) + 100000 + last_size / 2));
+    EXPECT_LT(KISS_ARENA_BytesAllocated(&arena), (int)(65 * sizeof(KISS_UINT) + 100000 + 64 + last_size / 2));
+
+    /* Clear releases all blocks but the largest and keeps using it */
+    KISS_ARENA_Clear(&arena);
+    EXPECT_EQ(stats.NumFree, 2);
+    EXPECT_EQ(KISS_ARENA_BytesAllocated(&arena), 0);
+    ASSERT_NE(KISS_ARENA_Alloc(&arena, last_size), NULL);
+    EXPECT_EQ(stats.NumAlloc, 3);
+
+    KISS_ARENA_Delete(&arena);
+    EXPECT_EQ(stats.NumFree, 3);
+
+    /* Without a buffer or callbacks the blocks come from the heap */
+    KISS_ARENA_CreateGrowable(&arena, NULL, 0, NULL, NULL, NULL);
+    for (int i = 0; i < 1000; ++i) {
+        ASSERT_NE(KISS_ARENA_AllocEx(&arena, 100, 8), NULL);
+    }
+    KISS_ARENA_Delete(&arena);
+}
+
+/* This test validates that nested marks release the allocations of their scope */
+UTEST(KISS_ARENA, MarkRewind) {
+    KISS_UINT buffer[256 / sizeof(KISS_UINT)];
+    KISS_ARENA arena;
+    KISS_ARENA_MARK outer;
+    KISS_ARENA_MARK inner;
+    KISS_ARENA_Create(&arena, buffer, sizeof(buffer));
+    void* pKeep = KISS_ARENA_Alloc(&arena, 16);
+    ASSERT_NE(pKeep, NULL);
+
+    KISS_ARENA_Mark(&arena, &outer);
+    ASSERT_NE(KISS_ARENA_Alloc(&arena, 32), NULL);
+    KISS_ARENA_Mark(&arena, &inner);
+    void* pInner = KISS_ARENA_Alloc(&arena, 64);
+    ASSERT_NE(pInner, NULL);
+    EXPECT_EQ(KISS_ARENA_BytesAllocated(&arena), 112);
+    KISS_ARENA_Rewind(&arena, &inner);
+    EXPECT_EQ(KISS_ARENA_BytesAllocated(&arena), 48);
+    /* The space is reused */
+    EXPECT_EQ(KISS_ARENA_Alloc(&arena, 64), pInner);
+    KISS_ARENA_Rewind(&arena, &outer);
+    EXPECT_EQ(KISS_ARENA_BytesAllocated(&arena), 16);
+
+    /* Rewinding an outer mark releases the inner ones too */
+    KISS_ARENA_Mark(&arena, &outer);
+    KISS_ARENA_Mark(&arena, &inner);
+    ASSERT_NE(KISS_ARENA_Alloc(&arena, 8), NULL);
+    KISS_ARENA_Rewind(&arena, &outer);
+    EXPECT_EQ(KISS_ARENA_BytesAllocated(&arena), 16);
+    EXPECT_EQ(arena.MarkDepth, 0);
+    KISS_ARENA_Delete(&arena);
+}
+
+/* This test validates that rewinding a growable arena releases the blocks obtained after the mark */
+UTEST(KISS_ARENA, MarkRewindGrowable) {
+    KISS_UINT buffer[256 / sizeof(KISS_UINT)];
+    ArenaBlockStats stats = { 0, 0, 0 };
+    KISS_ARENA arena;
+    KISS_ARENA_MARK mark;
+    KISS_ARENA_CreateGrowable(&arena, buffer, sizeof(buffer), ArenaTestAlloc, ArenaTestFree, &stats);
+    ASSERT_NE(KISS_ARENA_Alloc(&arena, 200), NULL);
+    KISS_ARENA_Mark(&arena, &mark);
+    ASSERT_NE(KISS_ARENA_Alloc(&arena, 100), NULL);
+    ASSERT_NE(KISS_ARENA_Alloc(&arena, 10000), NULL);
+    EXPECT_EQ(stats.NumAlloc, 2);
+    KISS_ARENA_Rewind(&arena, &mark);
+    EXPECT_EQ(stats.NumFree, 2);
+    EXPECT_EQ(KISS_ARENA_BytesAllocated(&arena), 200);
+    /* Back in the caller's buffer */
+    uint8_t* pData = (uint8_t*)KISS_ARENA_Alloc(&arena, 56);
+    EXPECT_EQ(pData, (uint8_t*)buffer);
+    KISS_ARENA_Delete(&arena);
+    EXPECT_EQ(stats.NumFree, 2);
+}
@@ -162,3 +162,56 @@ UTEST(KISS_ARRAY, CanSpliceItems)
     ASSERT_EQ(KISS_ARRAY_GetItemCount(&a), 31);
     KISS_ARRAY_Delete(&a);
 }
+
+typedef struct {
+    uint32_t a;
+    uint32_t b;
+} typed_array_item;
+KISS_ARRAY_DEFINE(TYPED_ARRAY, typed_array_item, 8)
+
+/* This test validates that the generated typed array behaves like KISS_ARRAY */
+UTEST(KISS_ARRAY, TypedArray)
+{
+    TYPED_ARRAY a;
+    typed_array_item item = { 0, 0 };
+    typed_array_item* pItem = NULL;
+    TYPED_ARRAY_Create(&a);
+    EXPECT_EQ(TYPED_ARRAY_GetItemCapacity(&a), 8);
+
+    for (uint32_t i = 0; i < 8; ++i) {
+        item.a = i;
+        item.b = i * 10;
+        ASSERT_NE(TYPED_ARRAY_PutBack(&a, &item), NULL);
+    }
+    EXPECT_EQ(TYPED_ARRAY_PutBack(&a, &item), NULL);
+    EXPECT_EQ(TYPED_ARRAY_GetItemCount(&a), 8);
+
+    /* Negative positions are relative to the end of the array */
+    ASSERT_EQ(TYPED_ARRAY_Get(&a, -1, &item), 0);
+    EXPECT_EQ(item.a, 7);
+    EXPECT_NE(TYPED_ARRAY_Get(&a, 8, &item), 0);
+
+    /* Erase preserves the order: 0 1 4 5 6 7 */
+    EXPECT_EQ(TYPED_ARRAY_Erase(&a, 2, 2), 6);
+    ASSERT_EQ(TYPED_ARRAY_GetPtr(&a, 2, &pItem), 0);
+    EXPECT_EQ(pItem->a, 4);
+
+    /* Remove moves the last elements into the hole: 0 6 7 5 */
+    EXPECT_EQ(TYPED_ARRAY_Remove(&a, 1, 2), 4);
+    EXPECT_EQ(a.Items[1].a, 6);
+    EXPECT_EQ(a.Items[2].a, 7);
+    EXPECT_EQ(a.Items[3].a, 5);
+
+    /* Insert at the front and the middle: 9 0 9 6 7 5 */
+    item.a = 9;
+    ASSERT_NE(TYPED_ARRAY_PutFront(&a, &item), NULL);
+    ASSERT_NE(TYPED_ARRAY_InsertAt(&a, 2, &item), NULL);
+    EXPECT_EQ(TYPED_ARRAY_GetItemCount(&a), 6);
+    EXPECT_EQ(a.Items[0].a, 9);
+    EXPECT_EQ(a.Items[1].a, 0);
+    EXPECT_EQ(a.Items[2].a, 9);
+    EXPECT_EQ(a.Items[3].a, 6);
+
+    TYPED_ARRAY_Clear(&a);
+    EXPECT_EQ(TYPED_ARRAY_GetItemCount(&a), 0);
+}
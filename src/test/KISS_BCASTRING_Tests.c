@@ -0,0 +1,183 @@
+#include "utest.h"
+#include "../kiss-ds/KISS_BCASTRING.h"
+
+/* This test validates that every reader receives every element */
+UTEST(KISS_BCASTRING, EveryReaderGetsEveryItem) {
+    static KISS_BCASTRING rb;
+    static KISS_UINT buffer[8];
+    KISS_BCASTRING_Create(&rb, sizeof(KISS_UINT), 8, buffer);
+    const int r0 = KISS_BCASTRING_AddReader(&rb);
+    const int r1 = KISS_BCASTRING_AddReader(&rb);
+    ASSERT_EQ(r0, 0);
+    ASSERT_EQ(r1, 1);
+
+    for (KISS_UINT i = 0; i < 5; ++i) {
+        ASSERT_EQ(KISS_BCASTRING_Put(&rb, &i), 0);
+    }
+    EXPECT_EQ(KISS_BCASTRING_GetItemCnt(&rb, r0), 5);
+    EXPECT_EQ(KISS_BCASTRING_GetItemCnt(&rb, r1), 5);
+
+    for (KISS_UINT i = 0; i < 5; ++i) {
+        KISS_UINT v = 0xFFFFFFFF;
+        KISS_UINT* pV = NULL;
+        ASSERT_EQ(KISS_BCASTRING_Get(&rb, r0, &v), 0);
+        EXPECT_EQ(v, i);
+        ASSERT_EQ(KISS_BCASTRING_GetPtr(&rb, r1, (void**)&pV), 0);
+        EXPECT_EQ(*pV, i);
+        KISS_BCASTRING_Purge(&rb, r1);
+    }
+    {
+        KISS_UINT v;
+        EXPECT_NE(KISS_BCASTRING_Get(&rb, r0, &v), 0);
+        EXPECT_NE(KISS_BCASTRING_Get(&rb, r1, &v), 0);
+    }
+    KISS_BCASTRING_Delete(&rb);
+}
+
+/* This test validates that the producer is only held back by the slowest reader */
+UTEST(KISS_BCASTRING, SlowestReaderBlocksProducer) {
+    static KISS_BCASTRING rb;
+    static KISS_UINT buffer[4];
+    KISS_UINT v = 0;
+    KISS_BCASTRING_Create(&rb, sizeof(KISS_UINT), 4, buffer);
+    const int fast = KISS_BCASTRING_AddReader(&rb);
+    const int slow = KISS_BCASTRING_AddReader(&rb);
+
+    for (KISS_UINT i = 0; i < 4; ++i) {
+        ASSERT_EQ(KISS_BCASTRING_Put(&rb, &i), 0);
+        ASSERT_EQ(KISS_BCASTRING_Get(&rb, fast, &v), 0);
+    }
+    /* The fast reader is empty but the slow reader still holds all 4 slots */
+    EXPECT_NE(KISS_BCASTRING_Put(&rb, &v), 0);
+    ASSERT_EQ(KISS_BCASTRING_Get(&rb, slow, &v), 0);
+    EXPECT_EQ(v, 0);
+    v = 4;
+    EXPECT_EQ(KISS_BCASTRING_Put(&rb, &v), 0);
+    EXPECT_EQ(KISS_BCASTRING_GetItemCnt(&rb, fast), 1);
+    EXPECT_EQ(KISS_BCASTRING_GetItemCnt(&rb, slow), 4);
+
+    /* A late reader only sees new elements */
+    const int late = KISS_BCASTRING_AddReader(&rb);
+    EXPECT_EQ(KISS_BCASTRING_GetItemCnt(&rb, late), 0);
+    KISS_BCASTRING_Delete(&rb);
+}
+
+/* This test validates that no more than KISS_BCASTRING_MAX_READERS can be registered */
+UTEST(KISS_BCASTRING, TooManyReaders) {
+    static KISS_BCASTRING rb;
+    static char buffer[4];
+    KISS_BCASTRING_Create(&rb, 1, 4, buffer);
+    for (int i = 0; i < KISS_BCASTRING_MAX_READERS; ++i) {
+        EXPECT_EQ(KISS_BCASTRING_AddReader(&rb), i);
+    }
+    EXPECT_EQ(KISS_BCASTRING_AddReader(&rb), -1);
+    KISS_BCASTRING_Delete(&rb);
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <pthread.h>
+#include <sched.h>
+
+#define BCAST_TEST_READERS 4
+#define BCAST_TEST_COUNT 20000
+
+typedef struct {
+    KISS_BCASTRING* pRB;
+    int ReaderId;
+    KISS_UINT NumInOrder;
+} bcast_test_arg;
+
+static void* bcastring_reader(void* pArg) {
+    bcast_test_arg* pTest = (bcast_test_arg*)pArg;
+    while (pTest->NumInOrder < BCAST_TEST_COUNT) {
+        KISS_UINT v;
+        if (KISS_BCASTRING_Get(pTest->pRB, pTest->ReaderId, &v) == 0) {
+            if (v != pTest->NumInOrder) {
+                break;
+            }
+            pTest->NumInOrder++;
+        }
+        else {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+/* This test validates that every reader thread receives the full stream in order */
+UTEST(KISS_BCASTRING, ReaderThreads) {
+    static KISS_BCASTRING rb;
+    static KISS_UINT buffer[64];
+    pthread_t threads[BCAST_TEST_READERS];
+    bcast_test_arg args[BCAST_TEST_READERS];
+    KISS_BCASTRING_Create(&rb, sizeof(KISS_UINT), 64, buffer);
+
+    for (int i = 0; i < BCAST_TEST_READERS; ++i) {
+        args[i].pRB = &rb;
+        args[i].ReaderId = KISS_BCASTRING_AddReader(&rb);
+        args[i].NumInOrder = 0;
+        ASSERT_EQ(pthread_create(&threads[i], NULL, bcastring_reader, &args[i]), 0);
+    }
+    for (KISS_UINT i = 0; i < BCAST_TEST_COUNT; ++i) {
+        while (KISS_BCASTRING_Put(&rb, &i) != 0) {
+            sched_yield();
+        }
+    }
+    for (int i = 0; i < BCAST_TEST_READERS; ++i) {
+        pthread_join(threads[i], NULL);
+        EXPECT_EQ(args[i].NumInOrder, BCAST_TEST_COUNT);
+    }
+    KISS_BCASTRING_Delete(&rb);
+}
+
+static KISS_UINT bcast_stop;
+
+static void* bcastring_producer(void* pArg) {
+    KISS_BCASTRING* pRB = (KISS_BCASTRING*)pArg;
+    for (KISS_UINT i = 0; KISS_ATOMIC_LOAD(&bcast_stop) == 0;) {
+        if (KISS_BCASTRING_Put(pRB, &i) == 0) {
+            ++i;
+        }
+        else {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+/* This test validates that a reader added while the producer runs never sees overwritten elements */
+UTEST(KISS_BCASTRING, AddReaderWhileProducing) {
+    static KISS_BCASTRING rb;
+    static KISS_UINT buffer[16];
+    pthread_t producer;
+    KISS_UINT num_in_order = 0;
+    KISS_BCASTRING_Create(&rb, sizeof(KISS_UINT), 16, buffer);
+    bcast_stop = 0;
+    ASSERT_EQ(pthread_create(&producer, NULL, bcastring_producer, &rb), 0);
+
+    /* Without readers the producer runs freely and laps the buffer */
+    while (KISS_ATOMIC_LOAD(&rb.oTail) < 1000) {
+        sched_yield();
+    }
+    const int reader = KISS_BCASTRING_AddReader(&rb);
+    ASSERT_EQ(reader, 0);
+    KISS_UINT expected = 0;
+    while (num_in_order < BCAST_TEST_COUNT) {
+        KISS_UINT v;
+        if (KISS_BCASTRING_Get(&rb, reader, &v) == 0) {
+            if (num_in_order > 0 && v != expected) {
+                break;
+            }
+            expected = v + 1;
+            num_in_order++;
+        }
+        else {
+            sched_yield();
+        }
+    }
+    KISS_ATOMIC_STORE(&bcast_stop, 1);
+    pthread_join(producer, NULL);
+    EXPECT_EQ(num_in_order, BCAST_TEST_COUNT);
+    KISS_BCASTRING_Delete(&rb);
+}
+#endif
@@ -0,0 +1,121 @@
+#include "utest.h"
+#include "../kiss-ds/KISS_MPMCRING.h"
+
+UTEST(KISS_MPMCRING, PutThenGet) {
+    KISS_MPMCRING rb;
+    static KISS_UINT buffer[KISS_MPMCRING_BUFFER_SIZE(sizeof(KISS_UINT), 16) / sizeof(KISS_UINT)];
+    KISS_MPMCRING_Create(&rb, sizeof(KISS_UINT), 16, buffer);
+    EXPECT_EQ(KISS_MPMCRING_GetItemCnt(&rb), 0);
+
+    for (KISS_UINT i = 0; i < 10; ++i) {
+        ASSERT_EQ(KISS_MPMCRING_Put(&rb, &i), 0);
+    }
+    EXPECT_EQ(KISS_MPMCRING_GetItemCnt(&rb), 10);
+
+    for (KISS_UINT i = 0; i < 10; ++i) {
+        KISS_UINT v = 0xFFFFFFFF;
+        ASSERT_EQ(KISS_MPMCRING_Get(&rb, &v), 0);
+        EXPECT_EQ(v, i);
+    }
+    {
+        KISS_UINT v = 0;
+        EXPECT_NE(KISS_MPMCRING_Get(&rb, &v), 0);
+    }
+    EXPECT_EQ(KISS_MPMCRING_GetItemCnt(&rb), 0);
+    KISS_MPMCRING_Delete(&rb);
+}
+
+/* This test validates that a full ring rejects further items and accepts them again after a Get */
+UTEST(KISS_MPMCRING, FullRingBufferShouldWrapAround) {
+    KISS_MPMCRING rb;
+    static KISS_UINT buffer[KISS_MPMCRING_BUFFER_SIZE(3, 8) / sizeof(KISS_UINT)];
+    char msg[3] = { 0 };
+    KISS_MPMCRING_Create(&rb, sizeof(msg), 8, buffer);
+
+    for (int i = 0; i < 8; ++i) {
+        msg[0] = (char)i;
+        ASSERT_EQ(KISS_MPMCRING_Put(&rb, msg), 0);
+    }
+    EXPECT_NE(KISS_MPMCRING_Put(&rb, msg), 0);
+    EXPECT_EQ(KISS_MPMCRING_GetItemCnt(&rb), 8);
+
+    for (int round = 0; round < 20; ++round) {
+        char out[3] = { 0 };
+        ASSERT_EQ(KISS_MPMCRING_Get(&rb, out), 0);
+        EXPECT_EQ(out[0], (char)round);
+        msg[0] = (char)(round + 8);
+        ASSERT_EQ(KISS_MPMCRING_Put(&rb, msg), 0);
+    }
+    EXPECT_EQ(KISS_MPMCRING_GetItemCnt(&rb), 8);
+    KISS_MPMCRING_Delete(&rb);
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <pthread.h>
+#include <sched.h>
+
+#define MPMC_TEST_THREADS 4
+#define MPMC_TEST_COUNT 20000
+
+typedef struct {
+    KISS_MPMCRING* pRB;
+    KISS_UINT Base;
+    uint64_t Sum;
+} mpmc_test_arg;
+
+static void* mpmcring_producer(void* pArg) {
+    mpmc_test_arg* pTest = (mpmc_test_arg*)pArg;
+    for (KISS_UINT i = 0; i < MPMC_TEST_COUNT; ++i) {
+        KISS_UINT v = pTest->Base + i;
+        while (KISS_MPMCRING_Put(pTest->pRB, &v) != 0) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void* mpmcring_consumer(void* pArg) {
+    mpmc_test_arg* pTest = (mpmc_test_arg*)pArg;
+    for (KISS_UINT i = 0; i < MPMC_TEST_COUNT; ++i) {
+        KISS_UINT v;
+        while (KISS_MPMCRING_Get(pTest->pRB, &v) != 0) {
+            sched_yield();
+        }
+        pTest->Sum += v;
+    }
+    return NULL;
+}
+
+/* This test validates that every item is received exactly once with several producer and consumer threads */
+UTEST(KISS_MPMCRING, ManyProducersManyConsumers) {
+    static KISS_MPMCRING rb;
+    static KISS_UINT buffer[KISS_MPMCRING_BUFFER_SIZE(sizeof(KISS_UINT), 64) / sizeof(KISS_UINT)];
+    pthread_t threads[2 * MPMC_TEST_THREADS];
+    mpmc_test_arg args[2 * MPMC_TEST_THREADS];
+    uint64_t expected = 0;
+    uint64_t actual = 0;
+    KISS_MPMCRING_Create(&rb, sizeof(KISS_UINT), 64, buffer);
+
+    for (int i = 0; i < 2 * MPMC_TEST_THREADS; ++i) {
+        args[i].pRB = &rb;
+        args[i].Base = (KISS_UINT)(i * MPMC_TEST_COUNT);
+        args[i].Sum = 0;
+        if (i < MPMC_TEST_THREADS) {
+            for (KISS_UINT j = 0; j < MPMC_TEST_COUNT; ++j) {
+                expected += args[i].Base + j;
+            }
+            ASSERT_EQ(pthread_create(&threads[i], NULL, mpmcring_producer, &args[i]), 0);
+        }
+        else {
+            ASSERT_EQ(pthread_create(&threads[i], NULL, mpmcring_consumer, &args[i]), 0);
+        }
+    }
+    for (int i = 0; i < 2 * MPMC_TEST_THREADS; ++i) {
+        pthread_join(threads[i], NULL);
+        actual += args[i].Sum;
+    }
+    EXPECT_EQ(actual, expected);
+    EXPECT_EQ(KISS_MPMCRING_GetItemCnt(&rb), 0);
+    KISS_MPMCRING_Delete(&rb);
+}
+#endif
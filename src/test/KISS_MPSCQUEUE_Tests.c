@@ -0,0 +1,229 @@
+#include "utest.h"
+#include "../kiss-ds/KISS_MPSCQUEUE.h"
+
+UTEST(KISS_MPSCQUEUE, PutThenGet) {
+    KISS_MPSCQUEUE q;
+    static uint64_t buffer[16];
+    const char* msgs[] = { "a", "hello", "variable length" };
+    KISS_MPSCQUEUE_Create(&q, buffer, sizeof(buffer));
+    EXPECT_EQ(KISS_MPSCQUEUE_GetByteCnt(&q), 0);
+
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_EQ(KISS_MPSCQUEUE_Put(&q, msgs[i], (KISS_UINT)strlen(msgs[i])), 0);
+    }
+    EXPECT_EQ(KISS_MPSCQUEUE_GetByteCnt(&q), 16 + 16 + 24);
+
+    for (int i = 0; i < 3; ++i) {
+        void* pData = NULL;
+        KISS_UINT size = 0;
+        ASSERT_EQ(KISS_MPSCQUEUE_GetPtr(&q, &pData, &size), 0);
+        EXPECT_EQ(size, (KISS_UINT)strlen(msgs[i]));
+        EXPECT_EQ(KISS_MEMCMP(pData, msgs[i], size), 0);
+        KISS_MPSCQUEUE_Purge(&q);
+    }
+    {
+        void* pData = NULL;
+        EXPECT_NE(KISS_MPSCQUEUE_GetPtr(&q, &pData, NULL), 0);
+    }
+    EXPECT_EQ(KISS_MPSCQUEUE_GetByteCnt(&q), 0);
+    KISS_MPSCQUEUE_Delete(&q);
+}
+
+/* This test validates that the consumer stops at a reserved item until it is committed */
+UTEST(KISS_MPSCQUEUE, ConsumerStopsAtUncommittedItem) {
+    KISS_MPSCQUEUE q;
+    static uint64_t buffer[16];
+    void* pData = NULL;
+    KISS_UINT size = 0;
+    KISS_MPSCQUEUE_Create(&q, buffer, sizeof(buffer));
+
+    char* pFirst = (char*)KISS_MPSCQUEUE_Alloc(&q, 3);
+    ASSERT_NE(pFirst, NULL);
+    ASSERT_EQ(KISS_MPSCQUEUE_Put(&q, "second", 6), 0);
+    EXPECT_NE(KISS_MPSCQUEUE_GetPtr(&q, &pData, &size), 0);
+
+    KISS_MEMCPY(pFirst, "1st", 3);
+    KISS_MPSCQUEUE_Commit(&q, pFirst);
+    ASSERT_EQ(KISS_MPSCQUEUE_GetPtr(&q, &pData, &size), 0);
+    EXPECT_EQ(size, 3);
+    EXPECT_EQ(KISS_MEMCMP(pData, "1st", 3), 0);
+    KISS_MPSCQUEUE_Purge(&q);
+    ASSERT_EQ(KISS_MPSCQUEUE_GetPtr(&q, &pData, &size), 0);
+    EXPECT_EQ(size, 6);
+    KISS_MPSCQUEUE_Purge(&q);
+    KISS_MPSCQUEUE_Delete(&q);
+}
+
+/* This test validates that records are padded around the end of the buffer and a full queue rejects items */
+UTEST(KISS_MPSCQUEUE, QueueShouldWrapAround) {
+    KISS_MPSCQUEUE q;
+    static uint64_t buffer[8];
+    char data[64] = { 0 };
+    KISS_UINT next_in = 0;
+    KISS_UINT next_out = 0;
+    KISS_MPSCQUEUE_Create(&q, buffer, sizeof(buffer));
+    EXPECT_NE(KISS_MPSCQUEUE_Put(&q, data, sizeof(data)), 0);
+
+    for (int round = 0; round < 50; ++round) {
+        const KISS_UINT size = 4 + (KISS_UINT)(round % 4) * 4;
+        KISS_MEMSET(data, (int)next_in, size);
+        while (KISS_MPSCQUEUE_Put(&q, data, size) != 0) {
+            uint8_t* pData = NULL;
+            KISS_UINT got = 0;
+            ASSERT_EQ(KISS_MPSCQUEUE_GetPtr(&q, (void**)&pData, &got), 0);
+            EXPECT_EQ(pData[0], (uint8_t)next_out);
+            EXPECT_EQ(pData[got - 1], (uint8_t)next_out);
+            next_out++;
+            KISS_MPSCQUEUE_Purge(&q);
+        }
+        next_in++;
+    }
+    while (next_out < next_in) {
+        uint8_t* pData = NULL;
+        ASSERT_EQ(KISS_MPSCQUEUE_GetPtr(&q, (void**)&pData, NULL), 0);
+        EXPECT_EQ(pData[0], (uint8_t)next_out);
+        next_out++;
+        KISS_MPSCQUEUE_Purge(&q);
+    }
+    EXPECT_EQ(KISS_MPSCQUEUE_GetByteCnt(&q), 0);
+    KISS_MPSCQUEUE_Delete(&q);
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <pthread.h>
+#include <sched.h>
+
+#define MPSCQ_TEST_PRODUCERS 4
+#define MPSCQ_TEST_COUNT 20000
+
+typedef struct {
+    KISS_MPSCQUEUE* pQ;
+    KISS_UINT Id;
+} mpscq_test_arg;
+
+static void* mpscqueue_producer(void* pArg) {
+    mpscq_test_arg* pTest = (mpscq_test_arg*)pArg;
+    KISS_UINT record[8];
+    for (KISS_UINT i = 0; i < MPSCQ_TEST_COUNT; ++i) {
+        const KISS_UINT n = 2 + i % 6;
+        record[0] = pTest->Id;
+        for (KISS_UINT j = 1; j < n; ++j) {
+            record[j] = i;
+        }
+        while (KISS_MPSCQUEUE_Put(pTest->pQ, record, n * sizeof(KISS_UINT)) != 0) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+/* This test validates that records from every producer arrive intact and in per-producer order */
+UTEST(KISS_MPSCQUEUE, ProducerThreads) {
+    static KISS_MPSCQUEUE q;
+    static uint64_t buffer[128];
+    pthread_t threads[MPSCQ_TEST_PRODUCERS];
+    mpscq_test_arg args[MPSCQ_TEST_PRODUCERS];
+    KISS_UINT next[MPSCQ_TEST_PRODUCERS] = { 0 };
+    KISS_UINT num_bad = 0;
+    KISS_MPSCQUEUE_Create(&q, buffer, sizeof(buffer));
+
+    for (KISS_UINT i = 0; i < MPSCQ_TEST_PRODUCERS; ++i) {
+        args[i].pQ = &q;
+        args[i].Id = i;
+        ASSERT_EQ(pthread_create(&threads[i], NULL, mpscqueue_producer, &args[i]), 0);
+    }
+    for (KISS_UINT total = 0; total < MPSCQ_TEST_PRODUCERS * MPSCQ_TEST_COUNT;) {
+        void* pData = NULL;
+        KISS_UINT size = 0;
+        if (KISS_MPSCQUEUE_GetPtr(&q, &pData, &size) == 0) {
+            const KISS_UINT* pRecord = (const KISS_UINT*)pData;
+            const KISS_UINT id = pRecord[0];
+            if (id < MPSCQ_TEST_PRODUCERS && size == (2 + next[id] % 6) * sizeof(KISS_UINT)) {
+                for (KISS_UINT j = 1; j < size / sizeof(KISS_UINT); ++j) {
+                    num_bad += (pRecord[j] != next[id]) ? 1 : 0;
+                }
+                next[id]++;
+            }
+            else {
+                num_bad++;
+            }
+            KISS_MPSCQUEUE_Purge(&q);
+            ++total;
+        }
+        else {
+            sched_yield();
+        }
+    }
+    for (KISS_UINT i = 0; i < MPSCQ_TEST_PRODUCERS; ++i) {
+        pthread_join(threads[i], NULL);
+        EXPECT_EQ(next[i], MPSCQ_TEST_COUNT);
+    }
+    EXPECT_EQ(num_bad, 0);
+    EXPECT_EQ(KISS_MPSCQUEUE_GetByteCnt(&q), 0);
+    KISS_MPSCQUEUE_Delete(&q);
+}
+
+/* Records each producer may have in the queue, far less than the queue holds */
+#define MPSCQ_TEST_IN_FLIGHT 64
+
+typedef struct {
+    KISS_MPSCQUEUE* pQ;
+    KISS_UINT Id;
+    KISS_UINT NumGot; /* Written by the consumer */
+    KISS_UINT NumFailed;
+} mpscq_credit_arg;
+
+static void* mpscqueue_credit_producer(void* pArg) {
+    mpscq_credit_arg* pTest = (mpscq_credit_arg*)pArg;
+    for (KISS_UINT i = 0; i < MPSCQ_TEST_COUNT;) {
+        if (i - KISS_ATOMIC_LOAD(&pTest->NumGot) >= MPSCQ_TEST_IN_FLIGHT) {
+            sched_yield();
+        }
+        else if (KISS_MPSCQUEUE_Put(pTest->pQ, &pTest->Id, sizeof(pTest->Id)) != 0) {
+            pTest->NumFailed++;
+        }
+        else {
+            ++i;
+        }
+    }
+    return NULL;
+}
+
+/* This test validates that Put never reports a full queue while the queue has room,
+   however the producers and the consumer interleave */
+UTEST(KISS_MPSCQUEUE, NotFullUnderContention) {
+    static KISS_MPSCQUEUE q;
+    static uint64_t buffer[4096];
+    pthread_t threads[MPSCQ_TEST_PRODUCERS];
+    static mpscq_credit_arg args[MPSCQ_TEST_PRODUCERS];
+    KISS_MPSCQUEUE_Create(&q, buffer, sizeof(buffer));
+
+    for (KISS_UINT i = 0; i < MPSCQ_TEST_PRODUCERS; ++i) {
+        args[i].pQ = &q;
+        args[i].Id = i;
+        args[i].NumGot = 0;
+        args[i].NumFailed = 0;
+        ASSERT_EQ(pthread_create(&threads[i], NULL, mpscqueue_credit_producer, &args[i]), 0);
+    }
+    for (KISS_UINT total = 0; total < MPSCQ_TEST_PRODUCERS * MPSCQ_TEST_COUNT;) {
+        void* pData = NULL;
+        if (KISS_MPSCQUEUE_GetPtr(&q, &pData, NULL) == 0) {
+            const KISS_UINT id = *(const KISS_UINT*)pData;
+            KISS_MPSCQUEUE_Purge(&q);
+            if (id < MPSCQ_TEST_PRODUCERS) {
+                KISS_ATOMIC_STORE(&args[id].NumGot, args[id].NumGot + 1);
+            }
+            ++total;
+        }
+        else {
+            sched_yield();
+        }
+    }
+    for (KISS_UINT i = 0; i < MPSCQ_TEST_PRODUCERS; ++i) {
+        pthread_join(threads[i], NULL);
+        EXPECT_EQ(args[i].NumGot, MPSCQ_TEST_COUNT);
+        EXPECT_EQ(args[i].NumFailed, 0);
+    }
+    KISS_MPSCQUEUE_Delete(&q);
+}
+#endif
@@ -0,0 +1,106 @@
+#include "utest.h"
+#include "../kiss-ds/KISS_QUEUEFILE.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <stdio.h>
+#include <unistd.h>
+
+/* This test validates that pending items are available again after the file is reopened */
+UTEST(KISS_QUEUEFILE, ItemsSurviveReopen) {
+    KISS_QUEUEFILE qf;
+    char path[64];
+    void* pData = NULL;
+    snprintf(path, sizeof(path), "/tmp/kiss-queuefile-%ld", (long)getpid());
+    unlink(path);
+
+    ASSERT_EQ(KISS_QUEUEFILE_Open(&qf, path, 256, 8, KISS_QUEUEFILE_SYNC_ASYNC), 0);
+    ASSERT_EQ(KISS_QUEUEFILE_Put(&qf, "first", 5), 0);
+    ASSERT_EQ(KISS_QUEUEFILE_Put(&qf, "second", 6), 0);
+    ASSERT_EQ(KISS_QUEUEFILE_Put(&qf, "third", 5), 0);
+    ASSERT_EQ(KISS_QUEUE_GetPtr(KISS_QUEUEFILE_GetQueue(&qf), &pData), 0);
+    KISS_QUEUEFILE_Purge(&qf);
+    /* Leave the head locked and a reservation open when closing */
+    ASSERT_EQ(KISS_QUEUE_GetPtr(KISS_QUEUEFILE_GetQueue(&qf), &pData), 0);
+    ASSERT_NE(KISS_QUEUE_Alloc(KISS_QUEUEFILE_GetQueue(&qf), 8), NULL);
+    KISS_QUEUEFILE_Close(&qf);
+
+    /* The parameters of the existing file are kept */
+    ASSERT_EQ(KISS_QUEUEFILE_Open(&qf, path, 16, 1, KISS_QUEUEFILE_SYNC_NONE), 0);
+    {
+        KISS_QUEUE* pQ = KISS_QUEUEFILE_GetQueue(&qf);
+        EXPECT_EQ(qf.SyncPolicy, KISS_QUEUEFILE_SYNC_ASYNC);
+        EXPECT_EQ(pQ->TotalSize, 256);
+        EXPECT_FALSE(KISS_QUEUE_IsInUse(pQ));
+        ASSERT_EQ(KISS_QUEUE_GetItemCnt(pQ), 2);
+        ASSERT_EQ(KISS_QUEUE_GetPtr(pQ, &pData), 0);
+        const uintptr_t misalign = (uintptr_t)pData % 8;
+        EXPECT_EQ(misalign, 0);
+        EXPECT_EQ(KISS_QUEUE_GetItemSize(pQ), 6);
+        EXPECT_EQ(KISS_MEMCMP(pData, "second", 6), 0);
+        KISS_QUEUEFILE_Purge(&qf);
+
+        /* Items can be built in place too */
+        char* pDest = (char*)KISS_QUEUE_Alloc(pQ, 16);
+        ASSERT_NE(pDest, NULL);
+        KISS_MEMCPY(pDest, "fourth", 6);
+        ASSERT_EQ(KISS_QUEUEFILE_Commit(&qf, 6), 0);
+        EXPECT_EQ(KISS_QUEUEFILE_Sync(&qf), 0);
+    }
+    KISS_QUEUEFILE_Close(&qf);
+
+    ASSERT_EQ(KISS_QUEUEFILE_Open(&qf, path, 256, 8, KISS_QUEUEFILE_SYNC_FULL), 0);
+    {
+        KISS_QUEUE* pQ = KISS_QUEUEFILE_GetQueue(&qf);
+        ASSERT_EQ(KISS_QUEUE_GetItemCnt(pQ), 2);
+        ASSERT_EQ(KISS_QUEUE_GetPtr(pQ, &pData), 0);
+        EXPECT_EQ(KISS_MEMCMP(pData, "third", 5), 0);
+        KISS_QUEUEFILE_Purge(&qf);
+        ASSERT_EQ(KISS_QUEUE_GetPtr(pQ, &pData), 0);
+        EXPECT_EQ(KISS_MEMCMP(pData, "fourth", 6), 0);
+        KISS_QUEUEFILE_Purge(&qf);
+    }
+    KISS_QUEUEFILE_Close(&qf);
+    unlink(path);
+}
+
+/* This test validates that a file which doesn't hold a queue is rejected */
+UTEST(KISS_QUEUEFILE, RejectForeignFile) {
+    KISS_QUEUEFILE qf;
+    char path[64];
+    FILE* f;
+    snprintf(path, sizeof(path), "/tmp/kiss-queuefile-bad-%ld", (long)getpid());
+    f = fopen(path, "wb");
+    ASSERT_NE(f, NULL);
+    for (int i = 0; i < 32; ++i) {
+        fputs("not a queue file ", f);
+    }
+    fclose(f);
+    EXPECT_NE(KISS_QUEUEFILE_Open(&qf, path, 256, 1, KISS_QUEUEFILE_SYNC_NONE), 0);
+    unlink(path);
+}
+
+/* This test validates that a queue whose state doesn't fit its storage is rejected */
+UTEST(KISS_QUEUEFILE, RejectCorruptQueue) {
+    KISS_QUEUEFILE qf;
+    char path[64];
+    snprintf(path, sizeof(path), "/tmp/kiss-queuefile-corrupt-%ld", (long)getpid());
+    for (int i = 0; i < 3; ++i) {
+        unlink(path);
+        ASSERT_EQ(KISS_QUEUEFILE_Open(&qf, path, 256, 8, KISS_QUEUEFILE_SYNC_NONE), 0);
+        ASSERT_EQ(KISS_QUEUEFILE_Put(&qf, "item", 4), 0);
+        KISS_QUEUE* pQ = KISS_QUEUEFILE_GetQueue(&qf);
+        if (i == 0) {
+            pQ->oTail = pQ->TotalSize + 8;
+        }
+        else if (i == 1) {
+            pQ->oHead = pQ->TotalSize;
+        }
+        else {
+            pQ->Alignment = 12;
+        }
+        KISS_QUEUEFILE_Close(&qf);
+        EXPECT_NE(KISS_QUEUEFILE_Open(&qf, path, 256, 8, KISS_QUEUEFILE_SYNC_NONE), 0);
+    }
+    unlink(path);
+}
+#endif
@@ -169,3 +169,420 @@ UTEST(KISS_QUEUE, QueueShouldWraparound) {
 
 
 
+
+/* This test validates that an item can be built in place and shrunk on commit */
+UTEST(KISS_QUEUE, AllocCommit) {
+    KISS_QUEUE q;
+    static char buffer[64];
+    KISS_QUEUE_Create(&q, buffer, sizeof(buffer));
+
+    /* Nothing is visible until the reservation is committed */
+    char* pDest = (char*)KISS_QUEUE_Alloc(&q, 32);
+    ASSERT_NE(pDest, NULL);
+    EXPECT_EQ(KISS_QUEUE_GetItemCnt(&q), 0);
+    KISS_MEMCPY(pDest, "abc", 3);
+    EXPECT_NE(KISS_QUEUE_Commit(&q, 33), 0);
+    EXPECT_EQ(KISS_QUEUE_Commit(&q, 3), 0);
+    EXPECT_NE(KISS_QUEUE_Commit(&q, 3), 0);
+    EXPECT_EQ(KISS_QUEUE_GetItemCnt(&q), 1);
+    EXPECT_EQ(KISS_QUEUE_GetItemSize(&q), 3);
+
+    /* The released part of the reservation is available to the next item */
+    pDest = (char*)KISS_QUEUE_Alloc(&q, 64 - 2 * 8 - 3);
+    ASSERT_NE(pDest, NULL);
+    KISS_MEMCPY(pDest, "defg", 4);
+    EXPECT_EQ(KISS_QUEUE_Commit(&q, 4), 0);
+    EXPECT_EQ(KISS_QUEUE_GetItemCnt(&q), 2);
+    {
+        void* pData = NULL;
+        ASSERT_EQ(KISS_QUEUE_GetPtr(&q, &pData), 0);
+        EXPECT_EQ(KISS_MEMCMP(pData, "abc", 3), 0);
+        KISS_QUEUE_Purge(&q);
+        ASSERT_EQ(KISS_QUEUE_GetPtr(&q, &pData), 0);
+        EXPECT_EQ(KISS_QUEUE_GetItemSize(&q), 4);
+        EXPECT_EQ(KISS_MEMCMP(pData, "defg", 4), 0);
+        KISS_QUEUE_Purge(&q);
+    }
+    KISS_QUEUE_Delete(&q);
+}
+
+/* This test validates that a wrapped queue never overwrites the head item, even in a dirty buffer */
+UTEST(KISS_QUEUE, WrappedQueueShouldNotOverwriteHead) {
+    KISS_QUEUE q;
+    char buffer[64];
+    KISS_UINT v = 0;
+    KISS_MEMSET(buffer, 0x5A, sizeof(buffer));
+    KISS_QUEUE_Create(&q, buffer, sizeof(buffer));
+
+    /* 5 items of 12 bytes, then free the first 2 so the next items wrap */
+    for (v = 0; v < 5; ++v) {
+        ASSERT_EQ(KISS_QUEUE_Put(&q, &v, sizeof(v)), 0);
+    }
+    for (int i = 0; i < 2; ++i) {
+        void* pData = NULL;
+        ASSERT_EQ(KISS_QUEUE_GetPtr(&q, &pData), 0);
+        KISS_QUEUE_Purge(&q);
+    }
+    /* [60, 64) is too small so the item wraps to [0, 12) */
+    ASSERT_EQ(KISS_QUEUE_Put(&q, &v, sizeof(v)), 0);
+    v++;
+    /* [12, 24) is free, anything larger would overwrite the head at 24 */
+    EXPECT_NE(KISS_QUEUE_Put(&q, buffer, 5), 0);
+    ASSERT_EQ(KISS_QUEUE_Put(&q, &v, sizeof(v)), 0);
+    EXPECT_NE(KISS_QUEUE_Put(&q, &v, 0), 0);
+    EXPECT_EQ(KISS_QUEUE_GetItemCnt(&q), 5);
+
+    for (KISS_UINT i = 2; i < 7; ++i) {
+        void* pData = NULL;
+        ASSERT_EQ(KISS_QUEUE_GetPtr(&q, &pData), 0);
+        EXPECT_EQ(*(KISS_UINT*)pData, i);
+        KISS_QUEUE_Purge(&q);
+    }
+    EXPECT_EQ(KISS_QUEUE_GetItemCnt(&q), 0);
+    KISS_QUEUE_Delete(&q);
+}
+
+/* This test validates that every payload is aligned and the padding is reported */
+UTEST(KISS_QUEUE, AlignedPayloads) {
+    KISS_QUEUE q;
+    static uint64_t buffer[64];
+    const KISS_UINT16 alignments[] = { 8, 16, 64 };
+    for (int a = 0; a < 3; ++a) {
+        /* Start at an odd offset so the first item needs padding too */
+        KISS_QUEUE_CreateEx(&q, (uint8_t*)buffer + 1, sizeof(buffer) - 1, alignments[a], 0);
+        KISS_UINT next_out = 0;
+        /* Keep a few items queued so the items wrap around the buffer */
+        for (KISS_UINT i = 0; i < 100; ++i) {
+            uint8_t item[16];
+            const KISS_UINT size = 1 + (i * 7) % 16;
+            KISS_MEMSET(item, (int)i, sizeof(item));
+            ASSERT_EQ(KISS_QUEUE_Put(&q, item, size), 0);
+            while (KISS_QUEUE_GetItemCnt(&q) > 3) {
+                void* pData = NULL;
+                ASSERT_EQ(KISS_QUEUE_GetPtr(&q, &pData), 0);
+                /* Keep % out of the EXPECT_EQ arguments, utest pastes them into its format string */
+                const uintptr_t misalign = (uintptr_t)pData % alignments[a];
+                const int expected_size = (int)(1 + (next_out * 7) % 16);
+                EXPECT_EQ(misalign, 0);
+                EXPECT_EQ(KISS_QUEUE_GetItemSize(&q), expected_size);
+                EXPECT_EQ(((uint8_t*)pData)[0], (uint8_t)next_out);
+                next_out++;
+                KISS_QUEUE_Purge(&q);
+            }
+        }
+        EXPECT_GT(KISS_QUEUE_GetPadBytes(&q), 0);
+        KISS_QUEUE_Delete(&q);
+    }
+
+    /* Alignment of 1 keeps the items packed */
+    KISS_QUEUE_Create(&q, (uint8_t*)buffer + 1, sizeof(buffer) - 1);
+    ASSERT_EQ(KISS_QUEUE_Put(&q, buffer, 3), 0);
+    ASSERT_EQ(KISS_QUEUE_Put(&q, buffer, 3), 0);
+    EXPECT_EQ(KISS_QUEUE_GetPadBytes(&q), 0);
+    KISS_QUEUE_Delete(&q);
+}
+
+/* This test validates that several items can be retrieved and purged in one batch */
+UTEST(KISS_QUEUE, BatchGetPurge) {
+    KISS_QUEUE q;
+    static char buffer[128];
+    KISS_QUEUE_SPAN spans[4];
+    const char* msgs[] = { "one", "two!", "three", "four", "fiver" };
+    KISS_QUEUE_Create(&q, buffer, sizeof(buffer));
+    EXPECT_EQ(KISS_QUEUE_GetPtrN(&q, spans, 4), 0);
+
+    for (int i = 0; i < 5; ++i) {
+        ASSERT_EQ(KISS_QUEUE_Put(&q, msgs[i], (KISS_UINT)strlen(msgs[i])), 0);
+    }
+    ASSERT_EQ(KISS_QUEUE_GetPtrN(&q, spans, 4), 4);
+    EXPECT_TRUE(KISS_QUEUE_IsInUse(&q));
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_EQ(spans[i].Size, (KISS_UINT)strlen(msgs[i]));
+        EXPECT_EQ(KISS_MEMCMP(spans[i].pData, msgs[i], spans[i].Size), 0);
+    }
+    /* Only part of the batch may be consumed */
+    KISS_QUEUE_PurgeN(&q, 3);
+    EXPECT_FALSE(KISS_QUEUE_IsInUse(&q));
+    EXPECT_EQ(KISS_QUEUE_GetItemCnt(&q), 2);
+
+    ASSERT_EQ(KISS_QUEUE_GetPtrN(&q, spans, 4), 2);
+    EXPECT_EQ(KISS_MEMCMP(spans[0].pData, "four", 4), 0);
+    EXPECT_EQ(KISS_MEMCMP(spans[1].pData, "fiver", 5), 0);
+    KISS_QUEUE_PurgeN(&q, 2);
+    EXPECT_EQ(KISS_QUEUE_GetItemCnt(&q), 0);
+    KISS_QUEUE_Delete(&q);
+}
+
+/* This test validates the compact header encoding, including wrap markers, alignment and shrinking */
+UTEST(KISS_QUEUE, CompactHeaders) {
+    KISS_QUEUE q;
+    static uint64_t buffer[64];
+    KISS_QUEUE_SPAN spans[8];
+
+    /* A 4 byte item takes 5 bytes */
+    KISS_QUEUE_CreateEx(&q, buffer, 50, 1, KISS_QUEUE_FLAG_COMPACT);
+    for (KISS_UINT i = 0; i < 10; ++i) {
+        ASSERT_EQ(KISS_QUEUE_Put(&q, &i, sizeof(i)), 0);
+    }
+    EXPECT_NE(KISS_QUEUE_Put(&q, buffer, 0), 0);
+    ASSERT_EQ(KISS_QUEUE_GetPtrN(&q, spans, 8), 8);
+    for (KISS_UINT i = 0; i < 8; ++i) {
+        EXPECT_EQ(spans[i].Size, sizeof(KISS_UINT));
+        EXPECT_EQ(KISS_MEMCMP(spans[i].pData, &i, sizeof(i)), 0);
+    }
+    KISS_QUEUE_PurgeN(&q, 8);
+    EXPECT_EQ(KISS_QUEUE_GetItemCnt(&q), 2);
+    KISS_QUEUE_Delete(&q);
+
+    /* Sizes around the 1 and 2 byte header boundary, wrapping around the buffer */
+    const KISS_UINT16 alignments[] = { 1, 8 };
+    for (int a = 0; a < 2; ++a) {
+        static uint8_t item[200];
+        KISS_UINT next_out = 0;
+        KISS_QUEUE_CreateEx(&q, (uint8_t*)buffer + 1, sizeof(buffer) - 1, alignments[a], KISS_QUEUE_FLAG_COMPACT);
+        for (KISS_UINT i = 0; i < 200; ++i) {
+            const KISS_UINT size = 100 + (i * 13) % 57;
+            KISS_MEMSET(item, (int)i, size);
+            while (KISS_QUEUE_Put(&q, item, size) != 0) {
+                void* pData = NULL;
+                ASSERT_EQ(KISS_QUEUE_GetPtr(&q, &pData), 0);
+                const uintptr_t misalign = (uintptr_t)pData % alignments[a];
+                const int expected_size = (int)(100 + (next_out * 13) % 57);
+                EXPECT_EQ(misalign, 0);
+                ASSERT_EQ(KISS_QUEUE_GetItemSize(&q), expected_size);
+                EXPECT_EQ(((uint8_t*)pData)[0], (uint8_t)next_out);
+                EXPECT_EQ(((uint8_t*)pData)[expected_size - 1], (uint8_t)next_out);
+                next_out++;
+                KISS_QUEUE_Purge(&q);
+            }
+        }
+        EXPECT_GT(next_out, 190);
+        KISS_QUEUE_Delete(&q);
+    }
+
+    /* A reservation with a 2 byte header keeps it when shrunk */
+    KISS_QUEUE_CreateEx(&q, buffer, sizeof(buffer), 1, KISS_QUEUE_FLAG_COMPACT);
+    EXPECT_EQ(KISS_QUEUE_Alloc(&q, KISS_QUEUE_COMPACT_MAX_SIZE + 1), NULL);
+    uint8_t* pDest = (uint8_t*)KISS_QUEUE_Alloc(&q, 200);
+    ASSERT_NE(pDest, NULL);
+    EXPECT_EQ(pDest, (uint8_t*)buffer + 2);
+    pDest[0] = 42;
+    ASSERT_EQ(KISS_QUEUE_Commit(&q, 1), 0);
+    ASSERT_EQ(KISS_QUEUE_Put(&q, "x", 1), 0);
+    ASSERT_EQ(KISS_QUEUE_GetPtrN(&q, spans, 8), 2);
+    EXPECT_EQ(spans[0].Size, 1);
+    EXPECT_EQ(*(uint8_t*)spans[0].pData, 42);
+    EXPECT_EQ(spans[1].pData, (void*)((uint8_t*)buffer + 4));
+    KISS_QUEUE_PurgeN(&q, 2);
+    KISS_QUEUE_Delete(&q);
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#if defined(__linux__) && !defined(F_SETPIPE_SZ)
+/* Only declared with _GNU_SOURCE */
+#define F_SETPIPE_SZ 1031
+#endif
+
+/* This test validates draining queued items to a pipe, including partial writes */
+UTEST(KISS_QUEUE, WriteFd) {
+    KISS_QUEUE q;
+    static char buffer[8192];
+    static char out[8192];
+    KISS_UINT offset = 0;
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+    KISS_QUEUE_Create(&q, buffer, sizeof(buffer));
+    EXPECT_EQ(KISS_QUEUE_WriteFd(&q, fds[1], &offset), 0);
+
+    ASSERT_EQ(KISS_QUEUE_Put(&q, "hello", 5), 0);
+    ASSERT_EQ(KISS_QUEUE_Put(&q, "", 0), 0);
+    ASSERT_EQ(KISS_QUEUE_Put(&q, " world", 6), 0);
+    /* Continue after 2 bytes of the front item were written by an earlier call */
+    offset = 2;
+    EXPECT_EQ(KISS_QUEUE_WriteFd(&q, fds[1], &offset), 9);
+    EXPECT_EQ(offset, 0);
+    EXPECT_EQ(KISS_QUEUE_GetItemCnt(&q), 0);
+    ASSERT_EQ(read(fds[0], out, sizeof(out)), 9);
+    EXPECT_EQ(KISS_MEMCMP(out, "llo world", 9), 0);
+
+#ifdef F_SETPIPE_SZ
+    /* Shrink the pipe so the writev() call is partial */
+    if (fcntl(fds[1], F_SETPIPE_SZ, 4096) == 4096) {
+        static char item[1000];
+        fcntl(fds[1], F_SETFL, O_NONBLOCK);
+        for (int i = 0; i < 6; ++i) {
+            KISS_MEMSET(item, 'a' + i, sizeof(item));
+            ASSERT_EQ(KISS_QUEUE_Put(&q, item, sizeof(item)), 0);
+        }
+        EXPECT_EQ(KISS_QUEUE_WriteFd(&q, fds[1], &offset), 4096);
+        EXPECT_EQ(KISS_QUEUE_GetItemCnt(&q), 2);
+        EXPECT_EQ(offset, 96);
+        EXPECT_EQ(KISS_QUEUE_WriteFd(&q, fds[1], &offset), -1);
+        ASSERT_EQ(read(fds[0], out, sizeof(out)), 4096);
+        EXPECT_EQ(out[3999], 'd');
+        EXPECT_EQ(out[4000], 'e');
+        EXPECT_EQ(KISS_QUEUE_WriteFd(&q, fds[1], &offset), 1904);
+        EXPECT_EQ(KISS_QUEUE_GetItemCnt(&q), 0);
+        EXPECT_EQ(offset, 0);
+        ASSERT_EQ(read(fds[0], out, sizeof(out)), 1904);
+        EXPECT_EQ(out[0], 'e');
+        EXPECT_EQ(out[903], 'e');
+        EXPECT_EQ(out[904], 'f');
+    }
+#endif
+    close(fds[0]);
+    close(fds[1]);
+    KISS_QUEUE_Delete(&q);
+}
+#endif
+
+/* This test validates that a full KISS_QUEUE_FLAG_OVERWRITE queue evicts its oldest items */
+UTEST(KISS_QUEUE, OverwriteOldest) {
+    KISS_QUEUE q;
+    static uint64_t buffer[16];
+    static uint8_t item[200];
+    const KISS_UINT16 flags[] = { KISS_QUEUE_FLAG_OVERWRITE, KISS_QUEUE_FLAG_OVERWRITE | KISS_QUEUE_FLAG_COMPACT };
+    for (int f = 0; f < 2; ++f) {
+        KISS_UINT num_put = 0;
+        KISS_UINT bytes_put = 0;
+        KISS_UINT bytes_got = 0;
+        KISS_QUEUE_CreateEx(&q, buffer, sizeof(buffer), 1, flags[f]);
+        for (KISS_UINT i = 0; i < 100; ++i) {
+            const KISS_UINT size = 1 + (i * 7) % 40;
+            KISS_MEMSET(item, (int)i, size);
+            ASSERT_EQ(KISS_QUEUE_Put(&q, item, size), 0);
+            num_put++;
+            bytes_put += size;
+        }
+        EXPECT_GT(KISS_QUEUE_GetDropCnt(&q), 0);
+        EXPECT_EQ(KISS_QUEUE_GetDropCnt(&q) + KISS_QUEUE_GetItemCnt(&q), num_put);
+        /* The most recent items are kept in order */
+        KISS_UINT expected = KISS_QUEUE_GetDropCnt(&q);
+        while (KISS_QUEUE_GetItemCnt(&q) > 0) {
+            void* pData = NULL;
+            ASSERT_EQ(KISS_QUEUE_GetPtr(&q, &pData), 0);
+            const int expected_size = (int)(1 + (expected * 7) % 40);
+            EXPECT_EQ(KISS_QUEUE_GetItemSize(&q), expected_size);
+            EXPECT_EQ(((uint8_t*)pData)[0], (uint8_t)expected);
+            bytes_got += KISS_QUEUE_GetItemSize(&q);
+            expected++;
+            KISS_QUEUE_Purge(&q);
+        }
+        EXPECT_EQ(expected, num_put);
+        EXPECT_EQ(KISS_QUEUE_GetDropBytes(&q) + bytes_got, bytes_put);
+
+        /* An item larger than the buffer fails without evicting anything */
+        const KISS_UINT num_dropped = KISS_QUEUE_GetDropCnt(&q);
+        ASSERT_EQ(KISS_QUEUE_Put(&q, item, 8), 0);
+        EXPECT_NE(KISS_QUEUE_Put(&q, item, sizeof(buffer)), 0);
+        EXPECT_EQ(KISS_QUEUE_GetItemCnt(&q), 1);
+        /* Nothing is evicted while the front is locked */
+        void* pFront = NULL;
+        ASSERT_EQ(KISS_QUEUE_GetPtr(&q, &pFront), 0);
+        while (KISS_QUEUE_Put(&q, item, 40) == 0) {
+        }
+        EXPECT_EQ(KISS_QUEUE_GetDropCnt(&q), num_dropped);
+        KISS_QUEUE_Purge(&q);
+        KISS_QUEUE_Delete(&q);
+    }
+}
+
+/* This test validates growing the tail item in place and by moving it to the start of the buffer */
+UTEST(KISS_QUEUE, AppendToTail) {
+    KISS_QUEUE q;
+    static uint64_t buffer[32];
+    const KISS_UINT16 flags[] = { 0, KISS_QUEUE_FLAG_COMPACT };
+    for (int f = 0; f < 2; ++f) {
+        void* pData = NULL;
+        KISS_QUEUE_CreateEx(&q, buffer, 128, 1, flags[f]);
+        EXPECT_NE(KISS_QUEUE_Append(&q, "x", 1), 0);
+
+        ASSERT_EQ(KISS_QUEUE_Put(&q, "ab", 2), 0);
+        ASSERT_EQ(KISS_QUEUE_Append(&q, "cd", 2), 0);
+        ASSERT_EQ(KISS_QUEUE_Append(&q, "", 0), 0);
+        ASSERT_EQ(KISS_QUEUE_Put(&q, "12", 2), 0);
+        ASSERT_EQ(KISS_QUEUE_Append(&q, "345", 3), 0);
+        EXPECT_EQ(KISS_QUEUE_GetItemCnt(&q), 2);
+        EXPECT_EQ(KISS_QUEUE_GetItemSize(&q), 4);
+        ASSERT_EQ(KISS_QUEUE_GetPtr(&q, &pData), 0);
+        EXPECT_EQ(KISS_MEMCMP(pData, "abcd", 4), 0);
+        /* The front item is locked */
+        EXPECT_NE(KISS_QUEUE_Append(&q, "6", 1), 0);
+        KISS_QUEUE_Purge(&q);
+        EXPECT_EQ(KISS_QUEUE_GetItemSize(&q), 5);
+        ASSERT_EQ(KISS_QUEUE_GetPtr(&q, &pData), 0);
+        EXPECT_EQ(KISS_MEMCMP(pData, "12345", 5), 0);
+        KISS_QUEUE_Purge(&q);
+
+        /* Fill the end of the buffer, free its start and grow the tail item across the end */
+        static uint8_t item[200];
+        KISS_MEMSET(item, 'a', sizeof(item));
+        ASSERT_EQ(KISS_QUEUE_Put(&q, item, 60), 0);
+        KISS_MEMSET(item, 'b', sizeof(item));
+        ASSERT_EQ(KISS_QUEUE_Put(&q, item, 20), 0);
+        KISS_MEMSET(item, 'c', sizeof(item));
+        ASSERT_EQ(KISS_QUEUE_Put(&q, item, 20), 0);
+        ASSERT_EQ(KISS_QUEUE_GetPtr(&q, &pData), 0);
+        KISS_QUEUE_Purge(&q);
+        /* Too large for the space in front of the head */
+        EXPECT_NE(KISS_QUEUE_Append(&q, item, 50), 0);
+        /* 200 bytes with a 2 byte compact header */
+        KISS_MEMSET(item, 'd', sizeof(item));
+        EXPECT_NE(KISS_QUEUE_Append(&q, item, 110), 0);
+        ASSERT_EQ(KISS_QUEUE_Append(&q, item, 30), 0);
+        ASSERT_EQ(KISS_QUEUE_Put(&q, "z", 1), 0);
+        EXPECT_EQ(KISS_QUEUE_GetItemCnt(&q), 3);
+
+        KISS_QUEUE_SPAN spans[4];
+        ASSERT_EQ(KISS_QUEUE_GetPtrN(&q, spans, 4), 3);
+        EXPECT_EQ(spans[0].Size, 20);
+        EXPECT_EQ(((uint8_t*)spans[0].pData)[0], 'b');
+        EXPECT_EQ(spans[1].Size, 50);
+        EXPECT_EQ(spans[1].pData < spans[0].pData, 1);
+        EXPECT_EQ(((uint8_t*)spans[1].pData)[19], 'c');
+        EXPECT_EQ(((uint8_t*)spans[1].pData)[20], 'd');
+        EXPECT_EQ(spans[2].Size, 1);
+        KISS_QUEUE_PurgeN(&q, 3);
+        KISS_QUEUE_Delete(&q);
+
+        /* The only item moves to the start of the buffer, with a larger compact header */
+        KISS_QUEUE_CreateEx(&q, buffer, sizeof(buffer), 1, flags[f]);
+        ASSERT_EQ(KISS_QUEUE_Put(&q, item, 40), 0);
+        ASSERT_EQ(KISS_QUEUE_Put(&q, item, 100), 0);
+        ASSERT_EQ(KISS_QUEUE_GetPtr(&q, &pData), 0);
+        KISS_QUEUE_Purge(&q);
+        KISS_MEMSET(item, 'e', sizeof(item));
+        ASSERT_EQ(KISS_QUEUE_Append(&q, item, 120), 0);
+        EXPECT_EQ(KISS_QUEUE_GetItemSize(&q), 220);
+        ASSERT_EQ(KISS_QUEUE_GetPtr(&q, &pData), 0);
+        EXPECT_EQ(pData, (void*)((uint8_t*)buffer + ((flags[f] & KISS_QUEUE_FLAG_COMPACT) ? 2 : 8)));
+        EXPECT_EQ(((uint8_t*)pData)[99], 'd');
+        EXPECT_EQ(((uint8_t*)pData)[100], 'e');
+        EXPECT_EQ(((uint8_t*)pData)[219], 'e');
+        KISS_QUEUE_Purge(&q);
+        EXPECT_EQ(KISS_QUEUE_GetItemCnt(&q), 0);
+        KISS_QUEUE_Delete(&q);
+
+        /* Growing past 127 bytes behind another item, the compact header grows in place */
+        static uint64_t large[128];
+        KISS_QUEUE_CreateEx(&q, large, sizeof(large), 1, flags[f]);
+        ASSERT_EQ(KISS_QUEUE_Put(&q, "f", 1), 0);
+        KISS_MEMSET(item, 'g', sizeof(item));
+        ASSERT_EQ(KISS_QUEUE_Put(&q, item, 100), 0);
+        KISS_MEMSET(item, 'h', sizeof(item));
+        ASSERT_EQ(KISS_QUEUE_Append(&q, item, 50), 0);
+        ASSERT_EQ(KISS_QUEUE_GetPtrN(&q, spans, 4), 2);
+        EXPECT_EQ(spans[0].Size, 1);
+        EXPECT_EQ(((uint8_t*)spans[0].pData)[0], 'f');
+        EXPECT_EQ(spans[1].Size, 150);
+        EXPECT_EQ(((uint8_t*)spans[1].pData)[0], 'g');
+        EXPECT_EQ(((uint8_t*)spans[1].pData)[99], 'g');
+        EXPECT_EQ(((uint8_t*)spans[1].pData)[100], 'h');
+        EXPECT_EQ(((uint8_t*)spans[1].pData)[149], 'h');
+        KISS_QUEUE_PurgeN(&q, 2);
+        EXPECT_EQ(KISS_QUEUE_GetItemCnt(&q), 0);
+        KISS_QUEUE_Delete(&q);
+    }
+}
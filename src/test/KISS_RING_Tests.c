@@ -157,3 +157,345 @@ UTEST(KISS_RING, PutFrontShouldWork) {
     KISS_RING_Delete(&mb);
 }
 
+
+/* This test validates that the power of 2 and modulo index arithmetic give the same results */
+UTEST(KISS_RING, Pow2AndModuloShouldMatch) {
+    KISS_RING pow2;
+    KISS_RING modulo;
+    KISS_RING odd;
+    static KISS_UINT buffer_pow2[8];
+    static KISS_UINT buffer_modulo[8];
+    static KISS_UINT buffer_odd[7];
+    KISS_RING_Create(&pow2, sizeof(KISS_UINT), 8, buffer_pow2);
+    KISS_RING_CreateEx(&modulo, sizeof(KISS_UINT), 8, buffer_modulo, KISS_RING_FLAG_MODULO);
+    KISS_RING_Create(&odd, sizeof(KISS_UINT), 7, buffer_odd);
+    EXPECT_TRUE(pow2.Flags & KISS_RING_FLAG_POW2);
+    EXPECT_FALSE(modulo.Flags & KISS_RING_FLAG_POW2);
+    EXPECT_FALSE(odd.Flags & KISS_RING_FLAG_POW2);
+
+    KISS_UINT next_in = 0;
+    KISS_UINT next_out = 0;
+    for (int round = 0; round < 10; ++round) {
+        /* Mix back and front insertions so both offsets wrap */
+        for (int i = 0; i < 5; ++i, ++next_in) {
+            ASSERT_EQ(KISS_RING_Put(&pow2, &next_in), 0);
+            ASSERT_EQ(KISS_RING_Put(&modulo, &next_in), 0);
+            ASSERT_EQ(KISS_RING_Put(&odd, &next_in), 0);
+        }
+        EXPECT_EQ(KISS_RING_GetItemCnt(&pow2), 5);
+        EXPECT_EQ(KISS_RING_GetItemCnt(&modulo), 5);
+        EXPECT_EQ(KISS_RING_GetItemCnt(&odd), 5);
+        {
+            KISS_UINT front = 0xFFFF;
+            ASSERT_EQ(KISS_RING_PutFront(&pow2, &front), 0);
+            ASSERT_EQ(KISS_RING_PutFront(&modulo, &front), 0);
+            ASSERT_EQ(KISS_RING_PutFront(&odd, &front), 0);
+            KISS_UINT a, b, c;
+            ASSERT_EQ(KISS_RING_Get(&pow2, &a), 0);
+            ASSERT_EQ(KISS_RING_Get(&modulo, &b), 0);
+            ASSERT_EQ(KISS_RING_Get(&odd, &c), 0);
+            EXPECT_EQ(a, front);
+            EXPECT_EQ(b, front);
+            EXPECT_EQ(c, front);
+        }
+        for (int i = 0; i < 5; ++i, ++next_out) {
+            KISS_UINT a, b, c;
+            ASSERT_EQ(KISS_RING_Get(&pow2, &a), 0);
+            ASSERT_EQ(KISS_RING_Get(&modulo, &b), 0);
+            ASSERT_EQ(KISS_RING_Get(&odd, &c), 0);
+            EXPECT_EQ(a, next_out);
+            EXPECT_EQ(b, next_out);
+            EXPECT_EQ(c, next_out);
+        }
+    }
+    EXPECT_EQ(KISS_RING_GetItemCnt(&pow2), 0);
+    EXPECT_EQ(KISS_RING_GetItemCnt(&modulo), 0);
+    EXPECT_EQ(KISS_RING_GetItemCnt(&odd), 0);
+    KISS_RING_Delete(&pow2);
+    KISS_RING_Delete(&modulo);
+    KISS_RING_Delete(&odd);
+}
+
+/* This test validates that the free running indices of a power of 2 ring buffer survive integer overflow */
+UTEST(KISS_RING, Pow2IndicesShouldOverflow) {
+    KISS_RING mb;
+    static char buffer[16];
+    KISS_RING_CreateEx(&mb, 1, sizeof(buffer), buffer, KISS_RING_FLAG_POW2);
+    mb.oHead = mb.oTail = 0xFFFFFFF8;
+
+    for (KISS_UINT i = 0; i < sizeof(buffer); ++i) {
+        char ch = (char)i;
+        ASSERT_EQ(KISS_RING_Put1(&mb, &ch), 0);
+    }
+    EXPECT_EQ(KISS_RING_GetItemCnt(&mb), sizeof(buffer));
+    {
+        char ch = 0x7F;
+        EXPECT_NE(KISS_RING_Put1(&mb, &ch), 0);
+    }
+    for (KISS_UINT i = 0; i < sizeof(buffer); ++i) {
+        char ch = 0x7F;
+        ASSERT_EQ(KISS_RING_Get1(&mb, &ch), 0);
+        EXPECT_EQ(ch, (char)i);
+    }
+    EXPECT_EQ(KISS_RING_GetItemCnt(&mb), 0);
+    KISS_RING_Delete(&mb);
+}
+
+/* This test validates that bulk transfers wrap around the end of the buffer and stop when full/empty */
+UTEST(KISS_RING, PutNGetNShouldWrapAround) {
+    static const KISS_UINT16 flags[] = { KISS_RING_FLAG_POW2, KISS_RING_FLAG_MODULO };
+    for (int f = 0; f < 2; ++f) {
+        KISS_RING mb;
+        static KISS_UINT buffer[8];
+        KISS_UINT input[12];
+        KISS_UINT output[12] = { 0 };
+        for (KISS_UINT i = 0; i < 12; ++i) {
+            input[i] = i + 100;
+        }
+        KISS_RING_CreateEx(&mb, sizeof(KISS_UINT), 8, buffer, flags[f]);
+
+        /* Move the offsets close to the end of the buffer */
+        EXPECT_EQ(KISS_RING_PutN(&mb, input, 6), 6);
+        EXPECT_EQ(KISS_RING_GetN(&mb, output, 6), 6);
+        EXPECT_EQ(KISS_MEMCMP(input, output, 6 * sizeof(KISS_UINT)), 0);
+
+        /* Only 8 of the 12 items fit, with the copy split around the wrap point */
+        EXPECT_EQ(KISS_RING_PutN(&mb, input, 12), 8);
+        EXPECT_EQ(KISS_RING_GetItemCnt(&mb), 8);
+        EXPECT_EQ(KISS_RING_PutN(&mb, input, 1), 0);
+
+        KISS_MEMSET(output, 0, sizeof(output));
+        EXPECT_EQ(KISS_RING_GetN(&mb, output, 3), 3);
+        EXPECT_EQ(KISS_RING_GetN(&mb, &output[3], 12), 5);
+        EXPECT_EQ(KISS_MEMCMP(input, output, 8 * sizeof(KISS_UINT)), 0);
+        EXPECT_EQ(KISS_RING_GetItemCnt(&mb), 0);
+        EXPECT_EQ(KISS_RING_GetN(&mb, output, 1), 0);
+        KISS_RING_Delete(&mb);
+    }
+}
+
+/* This test validates that elements can be built in place with Reserve/Commit */
+UTEST(KISS_RING, ReserveCommit) {
+    KISS_RING mb;
+    static KISS_UINT buffer[8];
+    KISS_UINT* pSlots = NULL;
+    KISS_RING_Create(&mb, sizeof(KISS_UINT), 8, buffer);
+
+    /* Nothing is visible until the reservation is committed */
+    ASSERT_EQ(KISS_RING_Reserve(&mb, (void**)&pSlots, 6), 6);
+    ASSERT_NE(pSlots, NULL);
+    for (KISS_UINT i = 0; i < 6; ++i) {
+        pSlots[i] = i;
+    }
+    EXPECT_EQ(KISS_RING_GetItemCnt(&mb), 0);
+    KISS_RING_Commit(&mb, 5);
+    EXPECT_EQ(KISS_RING_GetItemCnt(&mb), 5);
+
+    /* The reservation stops at the end of the buffer */
+    EXPECT_EQ(KISS_RING_Reserve(&mb, (void**)&pSlots, 8), 3);
+    EXPECT_EQ(pSlots, &buffer[5]);
+    KISS_RING_Commit(&mb, 0);
+    {
+        KISS_UINT out[4];
+        EXPECT_EQ(KISS_RING_GetN(&mb, out, 4), 4);
+        EXPECT_EQ(out[3], 3);
+    }
+    EXPECT_EQ(KISS_RING_Reserve(&mb, (void**)&pSlots, 8), 3);
+    pSlots[0] = 5;
+    pSlots[1] = 6;
+    pSlots[2] = 7;
+    KISS_RING_Commit(&mb, 3);
+    EXPECT_EQ(KISS_RING_Reserve(&mb, (void**)&pSlots, 8), 4);
+    EXPECT_EQ(pSlots, &buffer[0]);
+    pSlots[0] = 8;
+    KISS_RING_Commit(&mb, 1);
+
+    for (KISS_UINT i = 4; i <= 8; ++i) {
+        KISS_UINT v = 0;
+        ASSERT_EQ(KISS_RING_Get(&mb, &v), 0);
+        EXPECT_EQ(v, i);
+    }
+    EXPECT_EQ(KISS_RING_GetItemCnt(&mb), 0);
+    KISS_RING_Delete(&mb);
+}
+
+/* This test validates that a full ring buffer cannot be reserved */
+UTEST(KISS_RING, ReserveFullRingBuffer) {
+    KISS_RING mb;
+    static char buffer[16];
+    char* pSlot = NULL;
+    KISS_RING_Create(&mb, 1, sizeof(buffer), buffer);
+    EXPECT_EQ(KISS_RING_PutN(&mb, "0123456789abcdef", 16), 16);
+    EXPECT_EQ(KISS_RING_Reserve(&mb, (void**)&pSlot, 1), 0);
+    KISS_RING_Delete(&mb);
+}
+
+KISS_RING_DEFINE(TYPED_RING, uint64_t, 6)
+
+/* This test validates that the generated typed ring buffer behaves like KISS_RING */
+UTEST(KISS_RING, TypedRingBuffer) {
+    TYPED_RING rb;
+    uint64_t v = 0;
+    uint64_t* pV = NULL;
+    TYPED_RING_Create(&rb);
+
+    for (int round = 0; round < 4; ++round) {
+        for (uint64_t i = 0; i < 6; ++i) {
+            v = i << 40;
+            ASSERT_EQ(TYPED_RING_Put(&rb, &v), 0);
+        }
+        EXPECT_NE(TYPED_RING_Put(&rb, &v), 0);
+        EXPECT_NE(TYPED_RING_PutFront(&rb, &v), 0);
+        EXPECT_EQ(TYPED_RING_GetItemCnt(&rb), 6);
+
+        ASSERT_EQ(TYPED_RING_Get(&rb, &v), 0);
+        EXPECT_EQ(v, 0);
+        v = 99;
+        ASSERT_EQ(TYPED_RING_PutFront(&rb, &v), 0);
+        ASSERT_EQ(TYPED_RING_GetPtr(&rb, &pV), 0);
+        EXPECT_EQ(*pV, 99);
+        TYPED_RING_Purge(&rb);
+        for (uint64_t i = 1; i < 5; ++i) {
+            ASSERT_EQ(TYPED_RING_Get(&rb, &v), 0);
+            EXPECT_EQ(v, (i << 40));
+        }
+        ASSERT_EQ(TYPED_RING_Peek(&rb, &v), 0);
+        EXPECT_EQ(v, ((uint64_t)5 << 40));
+        TYPED_RING_Clear(&rb);
+        EXPECT_EQ(TYPED_RING_GetItemCnt(&rb), 0);
+    }
+}
+
+/* This test validates that an overwrite ring buffer keeps the newest elements and counts the dropped ones */
+UTEST(KISS_RING, OverwriteOldest) {
+    static const KISS_UINT16 flags[] = { KISS_RING_FLAG_POW2, KISS_RING_FLAG_MODULO };
+    for (int f = 0; f < 2; ++f) {
+        KISS_RING mb;
+        static KISS_UINT buffer[4];
+        KISS_UINT batch[6] = { 10, 11, 12, 13, 14, 15 };
+        KISS_UINT v = 0;
+        KISS_RING_CreateEx(&mb, sizeof(KISS_UINT), 4, buffer, flags[f] | KISS_RING_FLAG_OVERWRITE);
+
+        for (KISS_UINT i = 0; i < 6; ++i) {
+            ASSERT_EQ(KISS_RING_Put(&mb, &i), 0);
+        }
+        EXPECT_EQ(KISS_RING_GetItemCnt(&mb), 4);
+        EXPECT_EQ(KISS_RING_GetDropCnt(&mb), 2);
+        ASSERT_EQ(KISS_RING_Peek(&mb, &v), 0);
+        EXPECT_EQ(v, 2);
+
+        /* The head can't be overwritten while it is in use */
+        {
+            KISS_UINT* pHead = NULL;
+            ASSERT_EQ(KISS_RING_GetPtr(&mb, (void**)&pHead), 0);
+            EXPECT_NE(KISS_RING_Put(&mb, &v), 0);
+            EXPECT_EQ(KISS_RING_PutN(&mb, batch, 2), 0);
+            KISS_RING_Purge(&mb);
+            EXPECT_EQ(KISS_RING_GetDropCnt(&mb), 2);
+        }
+
+        /* Only the newest 4 elements of an oversized batch are kept */
+        EXPECT_EQ(KISS_RING_PutN(&mb, batch, 6), 4);
+        EXPECT_EQ(KISS_RING_GetDropCnt(&mb), 2 + 3 + 2);
+        for (KISS_UINT i = 12; i < 16; ++i) {
+            ASSERT_EQ(KISS_RING_Get(&mb, &v), 0);
+            EXPECT_EQ(v, i);
+        }
+        EXPECT_EQ(KISS_RING_GetItemCnt(&mb), 0);
+        KISS_RING_Delete(&mb);
+    }
+}
+
+/* This test validates indexed access and span iteration without consuming elements */
+UTEST(KISS_RING, PeekAtAndSpans) {
+    /* Exercise both the modulo and the masked index arithmetic */
+    const KISS_UINT capacities[] = { 5, 4 };
+    for (int c = 0; c < 2; ++c) {
+        KISS_RING mb;
+        KISS_UINT buffer[5];
+        KISS_RING_SPAN spans[2];
+        const KISS_UINT cap = capacities[c];
+        KISS_UINT v = 0;
+        KISS_RING_Create(&mb, sizeof(KISS_UINT), cap, buffer);
+        EXPECT_EQ(KISS_RING_GetSpans(&mb, spans), 0);
+        EXPECT_NE(KISS_RING_PeekAt(&mb, 0, &v), 0);
+
+        /* Move the head so the elements wrap around the end of the buffer */
+        for (KISS_UINT i = 0; i < 3; ++i) {
+            ASSERT_EQ(KISS_RING_Put(&mb, &i), 0);
+            ASSERT_EQ(KISS_RING_Get(&mb, &v), 0);
+        }
+        for (KISS_UINT i = 0; i < cap; ++i) {
+            ASSERT_EQ(KISS_RING_Put(&mb, &i), 0);
+        }
+        for (KISS_UINT i = 0; i < cap; ++i) {
+            KISS_UINT* pV = NULL;
+            ASSERT_EQ(KISS_RING_PeekAt(&mb, i, &v), 0);
+            EXPECT_EQ(v, i);
+            ASSERT_EQ(KISS_RING_PeekPtrAt(&mb, i, (void**)&pV), 0);
+            EXPECT_EQ(*pV, i);
+        }
+        EXPECT_NE(KISS_RING_PeekAt(&mb, cap, &v), 0);
+        EXPECT_EQ(KISS_RING_GetItemCnt(&mb), (int)cap);
+
+        ASSERT_EQ(KISS_RING_GetSpans(&mb, spans), 2);
+        EXPECT_EQ(spans[0].pData, (void*)&buffer[3]);
+        EXPECT_EQ(spans[0].Count, cap - 3);
+        EXPECT_EQ(spans[1].pData, (void*)&buffer[0]);
+        EXPECT_EQ(spans[1].Count, 3);
+        {
+            KISS_UINT expected = 0;
+            for (int s = 0; s < 2; ++s) {
+                const KISS_UINT* pItems = (const KISS_UINT*)spans[s].pData;
+                for (KISS_UINT i = 0; i < spans[s].Count; ++i) {
+                    EXPECT_EQ(pItems[i], expected++);
+                }
+            }
+        }
+
+        /* A single span once the elements no longer wrap */
+        while (KISS_RING_GetItemCnt(&mb) > 2) {
+            ASSERT_EQ(KISS_RING_Get(&mb, &v), 0);
+        }
+        ASSERT_EQ(KISS_RING_GetSpans(&mb, spans), 1);
+        EXPECT_EQ(spans[0].Count, 2);
+        KISS_RING_Delete(&mb);
+    }
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+
+/* This test validates moving bytes between a wrapped byte ring buffer and a pipe */
+UTEST(KISS_RING, ByteStreamFd) {
+    KISS_RING mb;
+    char buffer[8];
+    char data[8];
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+    KISS_RING_Create(&mb, 1, sizeof(buffer), buffer);
+
+    /* Move the offsets so both the free and the live region wrap */
+    EXPECT_EQ(KISS_RING_PutN(&mb, "abcde", 5), 5);
+    EXPECT_EQ(KISS_RING_GetN(&mb, data, 5), 5);
+
+    ASSERT_EQ(write(fds[1], "0123456789", 10), 10);
+    EXPECT_EQ(KISS_RING_ReadFd(&mb, fds[0]), 8);
+    EXPECT_EQ(KISS_RING_GetItemCnt(&mb), 8);
+    /* Nothing is read into a full ring buffer */
+    EXPECT_EQ(KISS_RING_ReadFd(&mb, fds[0]), 0);
+
+    EXPECT_EQ(KISS_RING_WriteFd(&mb, fds[1]), 8);
+    EXPECT_EQ(KISS_RING_GetItemCnt(&mb), 0);
+    EXPECT_EQ(KISS_RING_WriteFd(&mb, fds[1]), 0);
+
+    ASSERT_EQ(read(fds[0], data, sizeof(data)), 8);
+    EXPECT_EQ(KISS_MEMCMP(data, "89012345", 8), 0);
+
+    /* Error from the file descriptor is reported */
+    EXPECT_EQ(KISS_RING_ReadFd(&mb, -1), -1);
+    close(fds[0]);
+    close(fds[1]);
+    KISS_RING_Delete(&mb);
+}
+#endif
@@ -0,0 +1,106 @@
+#include "utest.h"
+#include "../kiss-ds/KISS_SHM.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <stdio.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/* This test validates that a ring buffer works through two mappings at different addresses */
+UTEST(KISS_SHM, SPSCRingTwoMappings) {
+    KISS_SHM producer;
+    KISS_SHM consumer;
+    KISS_SPSCRING* pTx = NULL;
+    KISS_SPSCRING* pRx = NULL;
+    char name[64];
+    snprintf(name, sizeof(name), "/kiss-shm-ring-%ld", (long)getpid());
+    KISS_SHM_Unlink(name);
+
+    ASSERT_EQ(KISS_SHM_CreateSPSCRing(&producer, name, sizeof(KISS_UINT), 16, &pTx), 0);
+    /* A second segment can't be created under the same name */
+    EXPECT_NE(KISS_SHM_CreateSPSCRing(&consumer, name, sizeof(KISS_UINT), 16, &pRx), 0);
+    /* The segment holds a ring buffer, not a queue */
+    {
+        KISS_SPSCQUEUE* pQ = NULL;
+        EXPECT_NE(KISS_SHM_AttachSPSCQueue(&consumer, name, &pQ), 0);
+    }
+    ASSERT_EQ(KISS_SHM_AttachSPSCRing(&consumer, name, &pRx), 0);
+    EXPECT_NE((void*)pTx, (void*)pRx);
+
+    for (KISS_UINT i = 0; i < 10; ++i) {
+        ASSERT_EQ(KISS_SPSCRING_Put(pTx, &i), 0);
+    }
+    EXPECT_EQ(KISS_SPSCRING_GetItemCnt(pRx), 10);
+    for (KISS_UINT i = 0; i < 10; ++i) {
+        KISS_UINT v = 0xFFFFFFFF;
+        ASSERT_EQ(KISS_SPSCRING_Get(pRx, &v), 0);
+        EXPECT_EQ(v, i);
+    }
+    KISS_SHM_Detach(&consumer);
+    KISS_SHM_Detach(&producer);
+    EXPECT_EQ(KISS_SHM_Unlink(name), 0);
+    EXPECT_NE(KISS_SHM_AttachSPSCRing(&consumer, name, &pRx), 0);
+}
+
+/* This test validates that variable length messages are exchanged with a child process */
+UTEST(KISS_SHM, SPSCQueueBetweenProcesses) {
+    KISS_SHM shm;
+    KISS_SPSCQUEUE* pQ = NULL;
+    char name[64];
+    snprintf(name, sizeof(name), "/kiss-shm-queue-%ld", (long)getpid());
+    KISS_SHM_Unlink(name);
+    ASSERT_EQ(KISS_SHM_CreateSPSCQueue(&shm, name, 256, &pQ), 0);
+
+    pid_t pid = fork();
+    ASSERT_NE(pid, -1);
+    if (pid == 0) {
+        /* Child: attach by name and send messages of increasing length */
+        KISS_SHM child;
+        KISS_SPSCQUEUE* pTx = NULL;
+        char msg[32];
+        if (KISS_SHM_AttachSPSCQueue(&child, name, &pTx) != 0) {
+            _exit(1);
+        }
+        for (int i = 0; i < 1000; ++i) {
+            KISS_MEMSET(msg, 'a' + i % 26, sizeof(msg));
+            while (KISS_SPSCQUEUE_Put(pTx, msg, 1 + i % 32) != 0) {
+                usleep(10);
+            }
+        }
+        KISS_SHM_Detach(&child);
+        _exit(0);
+    }
+    {
+        int num_ok = 0;
+        int status = 0;
+        int exited = 0;
+        for (int i = 0; i < 1000;) {
+            char* pData = NULL;
+            KISS_UINT size = 0;
+            if (KISS_SPSCQUEUE_GetPtr(pQ, (void**)&pData, &size) == 0) {
+                num_ok += (size == (KISS_UINT)(1 + i % 32) && pData[0] == 'a' + i % 26 && pData[size - 1] == 'a' + i % 26) ? 1 : 0;
+                KISS_SPSCQUEUE_Purge(pQ);
+                ++i;
+            }
+            else if (exited) {
+                /* The child exited early, e.g. it failed to attach: nothing more will arrive */
+                break;
+            }
+            else {
+                /* Check the queue once more after the child exits, it may have sent its last messages */
+                exited = (waitpid(pid, &status, WNOHANG) == pid);
+                if (!exited) {
+                    usleep(10);
+                }
+            }
+        }
+        if (!exited) {
+            waitpid(pid, &status, 0);
+        }
+        EXPECT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+        EXPECT_EQ(num_ok, 1000);
+    }
+    KISS_SHM_Detach(&shm);
+    KISS_SHM_Unlink(name);
+}
+#endif
@@ -0,0 +1,212 @@
+#include "utest.h"
+#include "../kiss-ds/KISS_SPSCQUEUE.h"
+
+UTEST(KISS_SPSCQUEUE, PutThenGet) {
+    KISS_SPSCQUEUE q;
+    static uint64_t buffer[16];
+    const char* msgs[] = { "a", "hello", "variable length" };
+    KISS_SPSCQUEUE_Create(&q, buffer, sizeof(buffer));
+    EXPECT_EQ(KISS_SPSCQUEUE_GetItemCnt(&q), 0);
+
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_EQ(KISS_SPSCQUEUE_Put(&q, msgs[i], (KISS_UINT)strlen(msgs[i])), 0);
+    }
+    EXPECT_EQ(KISS_SPSCQUEUE_GetItemCnt(&q), 3);
+
+    for (int i = 0; i < 3; ++i) {
+        void* pData = NULL;
+        KISS_UINT size = 0;
+        ASSERT_EQ(KISS_SPSCQUEUE_GetPtr(&q, &pData, &size), 0);
+        EXPECT_EQ(size, (KISS_UINT)strlen(msgs[i]));
+        EXPECT_EQ(KISS_MEMCMP(pData, msgs[i], size), 0);
+        KISS_SPSCQUEUE_Purge(&q);
+    }
+    {
+        void* pData = NULL;
+        EXPECT_NE(KISS_SPSCQUEUE_GetPtr(&q, &pData, NULL), 0);
+    }
+    EXPECT_EQ(KISS_SPSCQUEUE_GetItemCnt(&q), 0);
+    KISS_SPSCQUEUE_Delete(&q);
+}
+
+/* This test validates that the queue rejects items once full and that oversized items never fit */
+UTEST(KISS_SPSCQUEUE, FullQueue) {
+    KISS_SPSCQUEUE q;
+    static uint64_t buffer[8];
+    char data[64] = { 0 };
+    KISS_SPSCQUEUE_Create(&q, buffer, sizeof(buffer));
+
+    /* Each record takes 16 bytes. The last aligned slot always stays free so
+       a full queue can be told apart from an empty one */
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_EQ(KISS_SPSCQUEUE_Put(&q, data, 8), 0);
+    }
+    EXPECT_NE(KISS_SPSCQUEUE_Put(&q, data, 8), 0);
+    EXPECT_EQ(KISS_SPSCQUEUE_Put(&q, data, 0), 0);
+    EXPECT_NE(KISS_SPSCQUEUE_Put(&q, data, 0), 0);
+    EXPECT_EQ(KISS_SPSCQUEUE_GetItemCnt(&q), 4);
+    KISS_SPSCQUEUE_Delete(&q);
+
+    KISS_SPSCQUEUE_Create(&q, buffer, sizeof(buffer));
+    EXPECT_NE(KISS_SPSCQUEUE_Put(&q, data, sizeof(data)), 0);
+    KISS_SPSCQUEUE_Delete(&q);
+}
+
+/* This test validates that records which don't fit before the end are placed at the start */
+UTEST(KISS_SPSCQUEUE, QueueShouldWrapAround) {
+    KISS_SPSCQUEUE q;
+    static uint64_t buffer[16];
+    KISS_UINT next_in = 0;
+    KISS_UINT next_out = 0;
+    KISS_SPSCQUEUE_Create(&q, buffer, sizeof(buffer));
+
+    /* Vary the record sizes so the wrap point moves around the buffer */
+    for (int round = 0; round < 50; ++round) {
+        const KISS_UINT size = 4 + (KISS_UINT)(round % 5) * 4;
+        KISS_UINT record[6];
+        for (KISS_UINT i = 0; i < size / 4; ++i) {
+            record[i] = next_in;
+        }
+        while (KISS_SPSCQUEUE_Put(&q, record, size) != 0) {
+            void* pData = NULL;
+            KISS_UINT got = 0;
+            ASSERT_EQ(KISS_SPSCQUEUE_GetPtr(&q, &pData, &got), 0);
+            EXPECT_EQ(((KISS_UINT*)pData)[0], next_out);
+            EXPECT_EQ(((KISS_UINT*)pData)[got / 4 - 1], next_out);
+            next_out++;
+            KISS_SPSCQUEUE_Purge(&q);
+        }
+        next_in++;
+    }
+    while (next_out < next_in) {
+        void* pData = NULL;
+        KISS_UINT got = 0;
+        ASSERT_EQ(KISS_SPSCQUEUE_GetPtr(&q, &pData, &got), 0);
+        EXPECT_EQ(((KISS_UINT*)pData)[0], next_out);
+        next_out++;
+        KISS_SPSCQUEUE_Purge(&q);
+    }
+    EXPECT_EQ(KISS_SPSCQUEUE_GetItemCnt(&q), 0);
+    KISS_SPSCQUEUE_Delete(&q);
+}
+
+UTEST(KISS_SPSCQUEUE, PutEx) {
+    KISS_SPSCQUEUE q;
+    static uint64_t buffer[16];
+    const KISS_QUEUE_SRCLIST src[] = { { "Hello", 5 }, { ", ", 2 }, { "World", 5 } };
+    void* pData = NULL;
+    KISS_UINT size = 0;
+    KISS_SPSCQUEUE_Create(&q, buffer, sizeof(buffer));
+    ASSERT_EQ(KISS_SPSCQUEUE_PutEx(&q, src, 3), 0);
+    ASSERT_EQ(KISS_SPSCQUEUE_GetPtr(&q, &pData, &size), 0);
+    EXPECT_EQ(size, 12);
+    EXPECT_EQ(KISS_MEMCMP(pData, "Hello, World", 12), 0);
+    KISS_SPSCQUEUE_Purge(&q);
+    KISS_SPSCQUEUE_Delete(&q);
+}
+
+/* This test validates that a blocking Get times out on an empty queue */
+UTEST(KISS_SPSCQUEUE, GetWaitShouldTimeout) {
+    KISS_SPSCQUEUE q;
+    static uint64_t buffer[16];
+    void* pData = NULL;
+    KISS_UINT size = 0;
+    KISS_SPSCQUEUE_CreateEx(&q, buffer, sizeof(buffer), KISS_SPSCQUEUE_FLAG_BLOCKING);
+    EXPECT_NE(KISS_SPSCQUEUE_GetWait(&q, &pData, &size, 10), 0);
+    EXPECT_EQ(q.NumWaiters, 0);
+    ASSERT_EQ(KISS_SPSCQUEUE_Put(&q, "abc", 3), 0);
+    ASSERT_EQ(KISS_SPSCQUEUE_GetWait(&q, &pData, &size, 10), 0);
+    EXPECT_EQ(size, 3);
+    EXPECT_EQ(KISS_MEMCMP(pData, "abc", 3), 0);
+    KISS_SPSCQUEUE_Purge(&q);
+    KISS_SPSCQUEUE_Delete(&q);
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+#define SPSCQ_TEST_COUNT 50000
+
+static void* spscqueue_producer(void* pArg) {
+    KISS_SPSCQUEUE* pQ = (KISS_SPSCQUEUE*)pArg;
+    KISS_UINT record[8];
+    for (KISS_UINT i = 0; i < SPSCQ_TEST_COUNT; ++i) {
+        const KISS_UINT n = 1 + i % 8;
+        for (KISS_UINT j = 0; j < n; ++j) {
+            record[j] = i;
+        }
+        while (KISS_SPSCQUEUE_Put(pQ, record, n * sizeof(KISS_UINT)) != 0) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+/* This test validates that variable length records arrive intact and in order across threads */
+UTEST(KISS_SPSCQUEUE, ProducerConsumerThreads) {
+    static KISS_SPSCQUEUE q;
+    static uint64_t buffer[64];
+    pthread_t producer;
+    KISS_UINT num_ok = 0;
+    KISS_SPSCQUEUE_Create(&q, buffer, sizeof(buffer));
+    ASSERT_EQ(pthread_create(&producer, NULL, spscqueue_producer, &q), 0);
+
+    for (KISS_UINT i = 0; i < SPSCQ_TEST_COUNT;) {
+        void* pData = NULL;
+        KISS_UINT size = 0;
+        if (KISS_SPSCQUEUE_GetPtr(&q, &pData, &size) == 0) {
+            const KISS_UINT* pRecord = (const KISS_UINT*)pData;
+            const KISS_UINT n = 1 + i % 8;
+            KISS_BOOL ok = (size == n * sizeof(KISS_UINT));
+            for (KISS_UINT j = 0; ok && j < n; ++j) {
+                ok = (pRecord[j] == i);
+            }
+            num_ok += ok ? 1 : 0;
+            KISS_SPSCQUEUE_Purge(&q);
+            ++i;
+        }
+        else {
+            sched_yield();
+        }
+    }
+    pthread_join(producer, NULL);
+    EXPECT_EQ(num_ok, SPSCQ_TEST_COUNT);
+    EXPECT_EQ(KISS_SPSCQUEUE_GetItemCnt(&q), 0);
+    KISS_SPSCQUEUE_Delete(&q);
+}
+
+static void* spscqueue_slow_producer(void* pArg) {
+    KISS_SPSCQUEUE* pQ = (KISS_SPSCQUEUE*)pArg;
+    const struct timespec ts = { 0, 1000000 };
+    for (KISS_UINT i = 0; i < 20; ++i) {
+        nanosleep(&ts, NULL);
+        while (KISS_SPSCQUEUE_Put(pQ, &i, sizeof(i)) != 0) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+/* This test validates that a consumer blocked in GetWait is woken by the producer */
+UTEST(KISS_SPSCQUEUE, GetWaitShouldBeWoken) {
+    static KISS_SPSCQUEUE q;
+    static uint64_t buffer[16];
+    pthread_t producer;
+    KISS_SPSCQUEUE_CreateEx(&q, buffer, sizeof(buffer), KISS_SPSCQUEUE_FLAG_BLOCKING);
+
+    ASSERT_EQ(pthread_create(&producer, NULL, spscqueue_slow_producer, &q), 0);
+    for (KISS_UINT i = 0; i < 20; ++i) {
+        void* pData = NULL;
+        KISS_UINT size = 0;
+        ASSERT_EQ(KISS_SPSCQUEUE_GetWait(&q, &pData, &size, -1), 0);
+        EXPECT_EQ(size, sizeof(KISS_UINT));
+        EXPECT_EQ(*(const KISS_UINT*)pData, i);
+        KISS_SPSCQUEUE_Purge(&q);
+    }
+    pthread_join(producer, NULL);
+    EXPECT_EQ(q.NumWaiters, 0);
+    KISS_SPSCQUEUE_Delete(&q);
+}
+#endif
@@ -0,0 +1,161 @@
+#include "utest.h"
+#include "../kiss-ds/KISS_SPSCRING.h"
+
+UTEST(KISS_SPSCRING, PutThenGet) {
+    KISS_SPSCRING rb;
+    static KISS_UINT buffer[16];
+    KISS_SPSCRING_Create(&rb, sizeof(KISS_UINT), 16, buffer);
+    EXPECT_EQ(KISS_SPSCRING_GetItemCnt(&rb), 0);
+
+    for (KISS_UINT i = 0; i < 10; ++i) {
+        ASSERT_EQ(KISS_SPSCRING_Put(&rb, &i), 0);
+    }
+    EXPECT_EQ(KISS_SPSCRING_GetItemCnt(&rb), 10);
+
+    for (KISS_UINT i = 0; i < 10; ++i) {
+        KISS_UINT v = 0xFFFFFFFF;
+        ASSERT_EQ(KISS_SPSCRING_Get(&rb, &v), 0);
+        EXPECT_EQ(v, i);
+    }
+    EXPECT_EQ(KISS_SPSCRING_GetItemCnt(&rb), 0);
+    {
+        KISS_UINT v = 0;
+        EXPECT_NE(KISS_SPSCRING_Get(&rb, &v), 0);
+    }
+    KISS_SPSCRING_Delete(&rb);
+}
+
+/* This test validates that every slot can be used and a full ring rejects further items */
+UTEST(KISS_SPSCRING, FullRingBuffer) {
+    KISS_SPSCRING rb;
+    static char buffer[5];
+    KISS_SPSCRING_Create(&rb, 1, sizeof(buffer), buffer);
+
+    for (int i = 0; i < sizeof(buffer); ++i) {
+        char ch = (char)i;
+        ASSERT_EQ(KISS_SPSCRING_Put(&rb, &ch), 0);
+    }
+    EXPECT_EQ(KISS_SPSCRING_GetItemCnt(&rb), sizeof(buffer));
+    {
+        char ch = 0x7F;
+        EXPECT_NE(KISS_SPSCRING_Put(&rb, &ch), 0);
+    }
+    EXPECT_EQ(KISS_SPSCRING_GetItemCnt(&rb), sizeof(buffer));
+    KISS_SPSCRING_Delete(&rb);
+}
+
+UTEST(KISS_SPSCRING, RingBufferShouldWrapAround) {
+    KISS_SPSCRING rb;
+    static char buffer[7];
+    char next_in = 0;
+    char next_out = 0;
+    KISS_SPSCRING_Create(&rb, 1, sizeof(buffer), buffer);
+
+    /* Cycle through the indices several times with a partially filled ring */
+    for (int round = 0; round < 20; ++round) {
+        for (int i = 0; i < 5; ++i) {
+            ASSERT_EQ(KISS_SPSCRING_Put(&rb, &next_in), 0);
+            next_in++;
+        }
+        for (int i = 0; i < 5; ++i) {
+            char* pCh = NULL;
+            ASSERT_EQ(KISS_SPSCRING_GetPtr(&rb, (void**)&pCh), 0);
+            ASSERT_NE(pCh, NULL);
+            EXPECT_EQ(*pCh, next_out);
+            next_out++;
+            KISS_SPSCRING_Purge(&rb);
+        }
+        EXPECT_EQ(KISS_SPSCRING_GetItemCnt(&rb), 0);
+    }
+    KISS_SPSCRING_Delete(&rb);
+}
+
+/* This test validates that a blocking Get times out on an empty ring */
+UTEST(KISS_SPSCRING, GetWaitShouldTimeout) {
+    KISS_SPSCRING rb;
+    static KISS_UINT buffer[4];
+    KISS_UINT v = 7;
+    KISS_SPSCRING_CreateEx(&rb, sizeof(KISS_UINT), 4, buffer, KISS_SPSCRING_FLAG_BLOCKING);
+    EXPECT_NE(KISS_SPSCRING_GetWait(&rb, &v, 10), 0);
+    EXPECT_EQ(rb.NumWaiters, 0);
+    ASSERT_EQ(KISS_SPSCRING_Put(&rb, &v), 0);
+    v = 0;
+    EXPECT_EQ(KISS_SPSCRING_GetWait(&rb, &v, 10), 0);
+    EXPECT_EQ(v, 7);
+    KISS_SPSCRING_Delete(&rb);
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+#define SPSC_TEST_COUNT 100000
+
+static void* spscring_producer(void* pArg) {
+    KISS_SPSCRING* pRB = (KISS_SPSCRING*)pArg;
+    for (KISS_UINT i = 0; i < SPSC_TEST_COUNT; ++i) {
+        while (KISS_SPSCRING_Put(pRB, &i) != 0) {
+            /* Wait until the consumer frees a slot */
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+/* This test validates that items arrive in order when the producer and consumer run on separate threads */
+UTEST(KISS_SPSCRING, ProducerConsumerThreads) {
+    static KISS_SPSCRING rb;
+    static KISS_UINT buffer[64];
+    pthread_t producer;
+    KISS_UINT expected = 0;
+    KISS_SPSCRING_Create(&rb, sizeof(KISS_UINT), 64, buffer);
+
+    ASSERT_EQ(pthread_create(&producer, NULL, spscring_producer, &rb), 0);
+    while (expected < SPSC_TEST_COUNT) {
+        KISS_UINT v;
+        if (KISS_SPSCRING_Get(&rb, &v) == 0) {
+            if (v != expected) {
+                break;
+            }
+            expected++;
+        }
+        else {
+            sched_yield();
+        }
+    }
+    pthread_join(producer, NULL);
+    EXPECT_EQ(expected, SPSC_TEST_COUNT);
+    EXPECT_EQ(KISS_SPSCRING_GetItemCnt(&rb), 0);
+    KISS_SPSCRING_Delete(&rb);
+}
+static void* spscring_slow_producer(void* pArg) {
+    KISS_SPSCRING* pRB = (KISS_SPSCRING*)pArg;
+    const struct timespec ts = { 0, 1000000 };
+    for (KISS_UINT i = 0; i < 20; ++i) {
+        nanosleep(&ts, NULL);
+        while (KISS_SPSCRING_Put(pRB, &i) != 0) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+/* This test validates that a consumer blocked in GetWait is woken by the producer */
+UTEST(KISS_SPSCRING, GetWaitShouldBeWoken) {
+    static KISS_SPSCRING rb;
+    static KISS_UINT buffer[4];
+    pthread_t producer;
+    KISS_SPSCRING_CreateEx(&rb, sizeof(KISS_UINT), 4, buffer, KISS_SPSCRING_FLAG_BLOCKING);
+
+    ASSERT_EQ(pthread_create(&producer, NULL, spscring_slow_producer, &rb), 0);
+    for (KISS_UINT i = 0; i < 20; ++i) {
+        KISS_UINT v = 0xFFFFFFFF;
+        ASSERT_EQ(KISS_SPSCRING_GetWait(&rb, &v, -1), 0);
+        EXPECT_EQ(v, i);
+    }
+    pthread_join(producer, NULL);
+    EXPECT_EQ(rb.NumWaiters, 0);
+    KISS_SPSCRING_Delete(&rb);
+}
+#endif
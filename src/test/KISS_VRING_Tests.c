@@ -0,0 +1,69 @@
+#include "utest.h"
+#include "../kiss-ds/KISS_VRING.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+UTEST(KISS_VRING, CreationDeletion) {
+    KISS_VRING vr;
+    ASSERT_EQ(KISS_VRING_Create(&vr, 100), 0);
+    EXPECT_GE(KISS_VRING_GetSize(&vr), 100);
+    EXPECT_EQ(KISS_VRING_GetByteCnt(&vr), 0);
+    KISS_VRING_Delete(&vr);
+    EXPECT_EQ(KISS_VRING_GetSize(&vr), 0);
+}
+
+/* This test validates that the second mapping mirrors the first */
+UTEST(KISS_VRING, StorageShouldBeMirrored) {
+    KISS_VRING vr;
+    ASSERT_EQ(KISS_VRING_Create(&vr, 1), 0);
+    const KISS_UINT size = KISS_VRING_GetSize(&vr);
+    vr.pBuffer[0] = 'a';
+    vr.pBuffer[size - 1] = 'z';
+    EXPECT_EQ(vr.pBuffer[size], 'a');
+    vr.pBuffer[2 * size - 1] = 'y';
+    EXPECT_EQ(vr.pBuffer[size - 1], 'y');
+    KISS_VRING_Delete(&vr);
+}
+
+/* This test validates that data straddling the end of the buffer is read back as one contiguous span */
+UTEST(KISS_VRING, SpanShouldNotWrap) {
+    KISS_VRING vr;
+    static char scratch[16];
+    const char msg[] = "straddling message";
+    char* pData = NULL;
+    ASSERT_EQ(KISS_VRING_Create(&vr, 1), 0);
+    const KISS_UINT size = KISS_VRING_GetSize(&vr);
+
+    /* Move the offsets close to the end of the buffer */
+    for (KISS_UINT i = 0; i < size - 8; i += sizeof(scratch)) {
+        const KISS_UINT len = KISS_MIN(sizeof(scratch), size - 8 - i);
+        ASSERT_EQ(KISS_VRING_Write(&vr, scratch, len), len);
+        ASSERT_EQ(KISS_VRING_Read(&vr, scratch, len), len);
+    }
+    ASSERT_EQ(KISS_VRING_Write(&vr, msg, sizeof(msg)), sizeof(msg));
+    ASSERT_EQ(KISS_VRING_GetReadPtr(&vr, (void**)&pData), sizeof(msg));
+    EXPECT_STREQ(pData, msg);
+    KISS_VRING_Purge(&vr, sizeof(msg));
+    EXPECT_EQ(KISS_VRING_GetByteCnt(&vr), 0);
+    KISS_VRING_Delete(&vr);
+}
+
+/* This test validates that the ring buffer does not overflow and exposes all free space at once */
+UTEST(KISS_VRING, FullRingBuffer) {
+    KISS_VRING vr;
+    void* pFree = NULL;
+    ASSERT_EQ(KISS_VRING_Create(&vr, 1), 0);
+    const KISS_UINT size = KISS_VRING_GetSize(&vr);
+
+    ASSERT_EQ(KISS_VRING_GetWritePtr(&vr, &pFree), size);
+    KISS_MEMSET(pFree, 'x', size);
+    KISS_VRING_Commit(&vr, size - 1);
+    EXPECT_EQ(KISS_VRING_Write(&vr, "ab", 2), 1);
+    EXPECT_EQ(KISS_VRING_GetByteCnt(&vr), size);
+    EXPECT_EQ(KISS_VRING_GetWritePtr(&vr, &pFree), 0);
+
+    KISS_VRING_Purge(&vr, 10);
+    ASSERT_EQ(KISS_VRING_GetWritePtr(&vr, &pFree), 10);
+    EXPECT_EQ(pFree, vr.pBuffer);
+    KISS_VRING_Delete(&vr);
+}
+#endif
@@ -0,0 +1,40 @@
+#include "utest.h"
+#include "../kiss-ds/KISS_WAIT.h"
+
+/* This test validates that waiting on a word that no longer holds the expected value returns straight away */
+UTEST(KISS_WAIT, ValueAlreadyChanged) {
+    KISS_UINT word = 1;
+    EXPECT_EQ(KISS_WAIT_Wait(&word, 0, 1000), 0);
+}
+
+/* This test validates that waiting times out when nobody changes the word */
+UTEST(KISS_WAIT, WaitShouldTimeout) {
+    KISS_UINT word = 0;
+    EXPECT_EQ(KISS_WAIT_Wait(&word, 0, 10), 1);
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <pthread.h>
+#include <time.h>
+
+static void* wait_waker(void* pArg) {
+    KISS_UINT* pWord = (KISS_UINT*)pArg;
+    const struct timespec ts = { 0, 20000000 };
+    nanosleep(&ts, NULL);
+    KISS_ATOMIC_FETCH_ADD(pWord, 1);
+    KISS_WAIT_WakeAll(pWord);
+    return NULL;
+}
+
+/* This test validates that a blocked thread is woken when the word changes */
+UTEST(KISS_WAIT, WakeShouldUnblock) {
+    static KISS_UINT word = 0;
+    pthread_t waker;
+    ASSERT_EQ(pthread_create(&waker, NULL, wait_waker, &word), 0);
+    while (KISS_ATOMIC_LOAD(&word) == 0) {
+        KISS_WAIT_Wait(&word, 0, 5000);
+    }
+    pthread_join(waker, NULL);
+    EXPECT_EQ(word, 1);
+}
+#endif